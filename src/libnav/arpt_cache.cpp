@@ -0,0 +1,146 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for AirportCache class.
+*/
+
+
+#include "libnav/arpt_cache.hpp"
+
+
+namespace libnav
+{
+	// AirportCache definitions:
+	// Public member functions:
+
+	AirportCache::AirportCache(std::shared_ptr<ArptDB> arpt_db,
+		std::shared_ptr<NavaidDB> navaid_db, std::string cifp_path, size_t budget,
+		std::string postfix, bool use_pr, appr_pref_db_t pr_db,
+		std::shared_ptr<Executor> exec, std::shared_ptr<const CifpArchive> archive)
+	{
+		arpt_db_ptr = arpt_db;
+		navaid_db_ptr = navaid_db;
+		cifp_dir_path = cifp_path;
+		cifp_postfix = postfix;
+		mem_budget = budget;
+		use_appch_prefix = use_pr;
+		appch_prefix_db = pr_db;
+		cifp_archive = archive;
+
+		executor = exec;
+		if (executor == nullptr)
+		{
+			executor = get_default_executor();
+		}
+
+		mem_usage = 0;
+		n_hits = 0;
+		n_misses = 0;
+	}
+
+	airport_cptr_t AirportCache::get(std::string icao)
+	{
+		{
+			std::lock_guard<std::mutex> lock(cache_mutex);
+			auto it = entries.find(icao);
+			if (it != entries.end())
+			{
+				n_hits++;
+				lru.splice(lru.begin(), lru, it->second);
+				return it->second->apt;
+			}
+			n_misses++;
+		}
+
+		// The lock isn't held during the load so that hits aren't blocked by it.
+		airport_cptr_t apt = nullptr;
+		try
+		{
+			apt = Airport::load_async(icao, arpt_db_ptr, navaid_db_ptr, cifp_dir_path,
+				cifp_postfix, use_appch_prefix, appch_prefix_db, nullptr, executor,
+				cifp_archive).get();
+		}
+		catch (std::bad_alloc&)
+		{
+			return nullptr;
+		}
+		if (apt == nullptr || apt->err_code == DbErr::BAD_ALLOC)
+		{
+			return apt;
+		}
+
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		auto it = entries.find(icao);
+		if (it != entries.end())
+		{
+			// Someone else has added it in the meantime
+			lru.splice(lru.begin(), lru, it->second);
+			return it->second->apt;
+		}
+
+		size_t apt_mem = apt->get_mem_usage();
+		lru.push_front({ icao, apt, apt_mem });
+		entries[icao] = lru.begin();
+		mem_usage += apt_mem;
+		evict();
+
+		return apt;
+	}
+
+	void AirportCache::set_mem_budget(size_t budget)
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		mem_budget = budget;
+		evict();
+	}
+
+	void AirportCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		lru.clear();
+		entries.clear();
+		mem_usage = 0;
+	}
+
+	size_t AirportCache::get_mem_usage()
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		return mem_usage;
+	}
+
+	size_t AirportCache::get_n_airports()
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		return lru.size();
+	}
+
+	size_t AirportCache::get_n_hits()
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		return n_hits;
+	}
+
+	size_t AirportCache::get_n_misses()
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		return n_misses;
+	}
+
+	// Private member functions:
+
+	void AirportCache::evict()
+	{
+		while (mem_usage > mem_budget && lru.size() > 1)
+		{
+			cache_entry_t& last = lru.back();
+			mem_usage -= last.mem_usage;
+			entries.erase(last.icao);
+			lru.pop_back();
+		}
+	}
+}; // namespace libnav
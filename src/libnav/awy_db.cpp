@@ -40,14 +40,13 @@ namespace libnav
 
         if(int(s_split.size()) == N_COL_AIRAC)
         {
-            data.is_parsed = true;
             data.is_airac = true;
-            data.db_version = strutils::stoi_with_strip(s_split[0]);
-            data.airac_cycle = strutils::stoi_with_strip(s_split[AIRAC_CYCLE_WORD-1]);
+            data.is_parsed = data.set_airac(s_split[0], s_split[AIRAC_CYCLE_WORD-1]);
         }
         else if(int(s_split.size()) == N_AWY_COL_NORML)
         {
-            data.is_parsed = true;
+            data.is_parsed = strutils::str_to_int(s_split[8], &lower_fl) && 
+                strutils::str_to_int(s_split[9], &upper_fl);
 
             std::string tp_1 = s_split[2];
             std::string id_1 = s_split[0];
@@ -60,8 +59,6 @@ namespace libnav
             
             path_restr = s_split[6][0];
 
-            lower_fl = uint32_t(strutils::stoi_with_strip(s_split[8]));
-            upper_fl = uint32_t(strutils::stoi_with_strip(s_split[9]));
             awy_names = s_split[10];
 
             p1 = awy_point_t(id_1, tp_1, reg_code_1, lower_fl, upper_fl);
@@ -86,13 +83,70 @@ namespace libnav
         return data->db_ptr->is_in_awy(data->tgt_awy, curr);
     }
 
+    bool awy_wpt_to_set_func(std::string& curr, void* ref)
+    {
+        const std::vector<std::string> *tgt = 
+            reinterpret_cast<const std::vector<std::string>*>(ref);
+        for(size_t i = 0; i < tgt->size(); i++)
+        {
+            if(curr == tgt->at(i))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool awy_idx_wpt_to_wpt_func(uint32_t curr, void* ref)
+    {
+        return curr == *reinterpret_cast<uint32_t*>(ref);
+    }
+
+    bool awy_idx_awy_to_awy_func(uint32_t curr, void* ref)
+    {
+        awy_idx_to_awy_data_t *data = reinterpret_cast<awy_idx_to_awy_data_t*>(ref);
+        return data->db_ptr->is_in_awy(data->tgt_awy, curr);
+    }
+
+    static bool edge_less(const awy_edge_t& e1, const awy_edge_t& e2)
+    {
+        return e1.awy < e2.awy || (e1.awy == e2.awy && e1.to < e2.to);
+    }
+
+    void awy_scratch_t::start(size_t n_fixes)
+    {
+        if(visit_gen.size() < n_fixes)
+        {
+            visit_gen.resize(n_fixes, 0);
+            prev.resize(n_fixes);
+            prev_edge.resize(n_fixes);
+            queue.resize(n_fixes);
+        }
+        gen++;
+        if(gen == 0)
+        {
+            std::fill(visit_gen.begin(), visit_gen.end(), 0);
+            gen = 1;
+        }
+    }
+
     // AwyDB member function definitions:
     // Public member functions:
 
-    AwyDB::AwyDB(std::string awy_path)
+    AwyDB::AwyDB(std::string awy_path, std::shared_ptr<Executor> exec)
     {
-        db_loaded = std::async(std::launch::async, [](AwyDB* db, std::string awy_path) -> 
-				DbErr {return db->load_airways(awy_path); }, this, awy_path);
+        executor = exec;
+        if(executor == nullptr)
+        {
+            executor = get_default_executor();
+        }
+
+        db_loaded = submit_task(executor.get(), [this, awy_path]() -> 
+            DbErr {
+                DbErr err = load_airways(awy_path);
+                load_phase.set_ready(err);
+                return err;
+            });
     }
 
     DbErr AwyDB::get_err()
@@ -100,6 +154,16 @@ namespace libnav
         return db_loaded.get();
     }
 
+    LoadPhase& AwyDB::get_load_phase()
+    {
+        return load_phase;
+    }
+
+    void AwyDB::cancel_load()
+    {
+        cancel_requested.store(true);
+    }
+
     int AwyDB::get_airac()
     {
         return airac_cycle;
@@ -115,14 +179,135 @@ namespace libnav
         return awy_db;
     }
 
-    bool AwyDB::is_in_awy(std::string awy, std::string point)
+    bool AwyDB::is_in_awy(const std::string& awy, const std::string& point)
     {
-        if(awy_db.find(awy) != awy_db.end() && 
-            awy_db[awy].find(point) != awy_db[awy].end())
+        auto it = awy_db.find(awy);
+        return it != awy_db.end() && it->second.find(point) != it->second.end();
+    }
+
+    const awy_isect_t* AwyDB::get_isect(const std::string& awy)
+    {
+        auto it = isect_db.find(awy);
+        if(it == isect_db.end())
         {
-            return true;
+            return nullptr;
         }
-        return false;
+        return &it->second;
+    }
+
+    const std::vector<std::string>* AwyDB::get_shared_fixes(const std::string& awy, 
+        const std::string& other)
+    {
+        const awy_isect_t* isect = get_isect(awy);
+        if(isect == nullptr)
+        {
+            return nullptr;
+        }
+        auto it = isect->find(other);
+        if(it == isect->end())
+        {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    uint32_t AwyDB::get_fix_idx(const std::string& uid)
+    {
+        auto it = fix_ids.find(uid);
+        if(it == fix_ids.end())
+        {
+            return AWY_IDX_NONE;
+        }
+        return it->second;
+    }
+
+    size_t AwyDB::get_n_fixes()
+    {
+        return fix_uids.size();
+    }
+
+    const std::string& AwyDB::get_fix_uid(uint32_t idx)
+    {
+        return fix_uids[idx];
+    }
+
+    uint32_t AwyDB::get_awy_idx(const std::string& awy)
+    {
+        auto it = awy_ids.find(awy);
+        if(it == awy_ids.end())
+        {
+            return AWY_IDX_NONE;
+        }
+        return it->second;
+    }
+
+    size_t AwyDB::get_n_awys()
+    {
+        return awy_names.size();
+    }
+
+    const std::string& AwyDB::get_awy_name(uint32_t idx)
+    {
+        return awy_names[idx];
+    }
+
+    span_t<uint32_t> AwyDB::get_fix_awys(uint32_t idx)
+    {
+        span_t<uint32_t> out;
+        if(size_t(idx) < fix_uids.size())
+        {
+            out.ptr = fix_awys.data() + fix_awy_start[idx];
+            out.n = fix_awy_start[idx + 1] - fix_awy_start[idx];
+        }
+        return out;
+    }
+
+    span_t<uint32_t> AwyDB::get_fix_awys(const std::string& uid)
+    {
+        return get_fix_awys(get_fix_idx(uid));
+    }
+
+    span_t<awy_edge_t> AwyDB::get_fix_edges(uint32_t idx)
+    {
+        span_t<awy_edge_t> out;
+        if(size_t(idx) < fix_uids.size())
+        {
+            out.ptr = fix_edges.data() + fix_edge_start[idx];
+            out.n = fix_edge_start[idx + 1] - fix_edge_start[idx];
+        }
+        return out;
+    }
+
+    span_t<awy_edge_t> AwyDB::get_fix_edges(const std::string& uid)
+    {
+        return get_fix_edges(get_fix_idx(uid));
+    }
+
+    size_t AwyDB::link_navaids(std::shared_ptr<NavaidDB> navaid_db)
+    {
+        size_t n_unresolved = 0;
+        linked_navaid_db = navaid_db;
+        fix_wpts.assign(fix_uids.size(), nullptr);
+        for(size_t i = 0; i < fix_uids.size(); i++)
+        {
+            fix_wpts[i] = navaid_db->find_wpt_by_awy_str(fix_uids[i]);
+            n_unresolved += size_t(fix_wpts[i] == nullptr);
+        }
+        return n_unresolved;
+    }
+
+    bool AwyDB::is_linked()
+    {
+        return linked_navaid_db != nullptr;
+    }
+
+    const waypoint_entry_t* AwyDB::get_fix_wpt(uint32_t idx)
+    {
+        if(size_t(idx) < fix_wpts.size())
+        {
+            return fix_wpts[idx];
+        }
+        return nullptr;
     }
 
     size_t AwyDB::get_ww_path(std::string awy, std::string start, 
@@ -139,13 +324,23 @@ namespace libnav
     size_t AwyDB::get_aa_path(std::string awy, std::string start, 
         std::string next_awy, std::vector<awy_point_t>* out)
     {
-        if(is_in_awy(awy, start))
+        if(!is_in_awy(awy, start))
+        {
+            return 0;
+        }
+        if(awy == next_awy)
         {
-            awy_to_awy_data_t awy_data = {next_awy, this};
-            return get_path(awy, start, out, awy_awy_to_awy_func, &awy_data);
+            return get_path(awy, start, out, awy_wpt_to_wpt_func, &start);
         }
 
-        return 0;
+        const std::vector<std::string>* tgt = get_shared_fixes(awy, next_awy);
+        if(tgt == nullptr)
+        {
+            return 0;
+        }
+        // awy_wpt_to_set_func doesn't modify the targets
+        return get_path(awy, start, out, awy_wpt_to_set_func, 
+            const_cast<std::vector<std::string>*>(tgt));
     }
 
     size_t AwyDB::get_path(std::string awy, std::string start, 
@@ -212,9 +407,127 @@ namespace libnav
         return out->size();
     }
 
-    AwyDB::~AwyDB()
+    bool AwyDB::is_in_awy(uint32_t awy, uint32_t fix)
     {
+        span_t<uint32_t> awys = get_fix_awys(fix);
+        return std::binary_search(awys.begin(), awys.end(), awy);
+    }
 
+    size_t AwyDB::get_ww_path(uint32_t awy, uint32_t start, uint32_t end, 
+        awy_scratch_t* scratch, std::vector<awy_hop_t>* out)
+    {
+        if(is_in_awy(awy, start) && is_in_awy(awy, end))
+        {
+            return get_path(awy, start, scratch, out, awy_idx_wpt_to_wpt_func, &end);
+        }
+
+        return 0;
+    }
+
+    size_t AwyDB::get_aa_path(uint32_t awy, uint32_t start, uint32_t next_awy, 
+        awy_scratch_t* scratch, std::vector<awy_hop_t>* out)
+    {
+        if(is_in_awy(awy, start))
+        {
+            awy_idx_to_awy_data_t awy_data = {next_awy, this};
+            return get_path(awy, start, scratch, out, awy_idx_awy_to_awy_func, &awy_data);
+        }
+
+        return 0;
+    }
+
+    size_t AwyDB::get_path(uint32_t awy, uint32_t start, awy_scratch_t* scratch, 
+        std::vector<awy_hop_t>* out, awy_idx_path_func_t path_func, void* ref)
+    {
+        if(size_t(start) >= fix_uids.size())
+        {
+            return 0;
+        }
+
+        scratch->start(fix_uids.size());
+        uint32_t gen = scratch->gen;
+        uint32_t *visit_gen = scratch->visit_gen.data();
+        uint32_t *prev = scratch->prev.data();
+        uint32_t *prev_edge = scratch->prev_edge.data();
+        uint32_t *queue = scratch->queue.data();
+        size_t q_head = 0;
+        size_t q_tail = 0;
+
+        queue[q_tail++] = start;
+        visit_gen[start] = gen;
+        prev[start] = start;
+
+        uint32_t end = AWY_IDX_NONE;
+        while(q_head < q_tail)
+        {
+            uint32_t curr = queue[q_head++];
+            if(path_func(curr, ref))
+            {
+                end = curr;
+                break;
+            }
+
+            // Segments are sorted by airway, so only the ones of awy are visited
+            for(uint32_t i = fix_edge_start[curr]; i < fix_edge_start[curr + 1]; i++)
+            {
+                const awy_edge_t& e = fix_edges[i];
+                if(e.awy < awy)
+                {
+                    continue;
+                }
+                if(e.awy > awy)
+                {
+                    break;
+                }
+                if(visit_gen[e.to] != gen)
+                {
+                    visit_gen[e.to] = gen;
+                    prev[e.to] = curr;
+                    prev_edge[e.to] = i;
+                    queue[q_tail++] = e.to;
+                }
+            }
+        }
+
+        if(end == AWY_IDX_NONE)
+        {
+            return 0;
+        }
+
+        size_t n_hops = 1;
+        for(uint32_t curr = end; prev[curr] != curr; curr = prev[curr])
+        {
+            n_hops++;
+        }
+
+        size_t base = out->size();
+        out->resize(base + n_hops);
+        awy_hop_t *hops = out->data() + base;
+        size_t pos = n_hops - 1;
+        hops[pos].fix = end;
+        hops[pos].alt_restr = {0, 0};
+        if(n_hops > 1)
+        {
+            hops[pos].alt_restr = fix_edges[prev_edge[end]].alt_restr;
+        }
+        for(uint32_t curr = end; prev[curr] != curr; curr = prev[curr])
+        {
+            pos--;
+            hops[pos].fix = prev[curr];
+            hops[pos].alt_restr = fix_edges[prev_edge[curr]].alt_restr;
+        }
+
+        return out->size();
+    }
+
+    AwyDB::~AwyDB()
+    {
+        // The load task references this object, so it must finish first.
+        cancel_load();
+        if(db_loaded.valid())
+        {
+            db_loaded.wait();
+        }
     }
 
     DbErr AwyDB::load_airways(std::string awy_path)
@@ -229,6 +542,11 @@ namespace libnav
             int i = 1;
 			while (getline(file, line))
 			{
+                if(cancel_requested.load(std::memory_order_relaxed))
+                {
+                    return DbErr::CANCELLED;
+                }
+
                 awy_line_t awy_line(line);
                 if(!awy_line.data.is_parsed && i > N_EARTH_LINES_IGNORE)
                 {
@@ -267,6 +585,10 @@ namespace libnav
         {
             return DbErr::FILE_NOT_FOUND;
         }
+
+        build_fix_index();
+        build_isect_db();
+
         return out_code;
     }
 
@@ -305,4 +627,92 @@ namespace libnav
             }
         }
     }
+
+    void AwyDB::build_fix_index()
+    {
+        for(auto& awy: awy_db)
+        {
+            awy_names.push_back(awy.first);
+            for(auto& fix: awy.second)
+            {
+                if(fix_ids.find(fix.first) == fix_ids.end())
+                {
+                    fix_ids[fix.first] = 0;
+                    fix_uids.push_back(fix.first);
+                }
+            }
+        }
+        std::sort(awy_names.begin(), awy_names.end());
+        std::sort(fix_uids.begin(), fix_uids.end());
+        for(size_t i = 0; i < awy_names.size(); i++)
+        {
+            awy_ids[awy_names[i]] = uint32_t(i);
+        }
+        for(size_t i = 0; i < fix_uids.size(); i++)
+        {
+            fix_ids[fix_uids[i]] = uint32_t(i);
+        }
+
+        fix_awy_start.assign(fix_uids.size() + 1, 0);
+        fix_edge_start.assign(fix_uids.size() + 1, 0);
+        for(auto& awy: awy_db)
+        {
+            for(auto& fix: awy.second)
+            {
+                uint32_t idx = fix_ids[fix.first];
+                fix_awy_start[idx + 1]++;
+                fix_edge_start[idx + 1] += uint32_t(fix.second.size());
+            }
+        }
+        for(size_t i = 1; i < fix_awy_start.size(); i++)
+        {
+            fix_awy_start[i] += fix_awy_start[i - 1];
+            fix_edge_start[i] += fix_edge_start[i - 1];
+        }
+
+        std::vector<uint32_t> awy_fill(fix_awy_start.begin(), fix_awy_start.end() - 1);
+        std::vector<uint32_t> edge_fill(fix_edge_start.begin(), fix_edge_start.end() - 1);
+        fix_awys.resize(fix_awy_start.back());
+        fix_edges.resize(fix_edge_start.back());
+        for(auto& awy: awy_db)
+        {
+            uint32_t awy_idx = awy_ids[awy.first];
+            for(auto& fix: awy.second)
+            {
+                uint32_t idx = fix_ids[fix.first];
+                fix_awys[awy_fill[idx]++] = awy_idx;
+                for(auto& nb: fix.second)
+                {
+                    fix_edges[edge_fill[idx]++] = {fix_ids[nb.first], awy_idx, nb.second};
+                }
+            }
+        }
+
+        for(size_t i = 0; i < fix_uids.size(); i++)
+        {
+            std::sort(fix_awys.begin() + fix_awy_start[i], 
+                fix_awys.begin() + fix_awy_start[i + 1]);
+            std::sort(fix_edges.begin() + fix_edge_start[i], 
+                fix_edges.begin() + fix_edge_start[i + 1], edge_less);
+        }
+    }
+
+    void AwyDB::build_isect_db()
+    {
+        for(uint32_t i = 0; i < uint32_t(fix_uids.size()); i++)
+        {
+            span_t<uint32_t> awys = get_fix_awys(i);
+            for(size_t j = 0; j < awys.size(); j++)
+            {
+                for(size_t k = 0; k < awys.size(); k++)
+                {
+                    if(j != k)
+                    {
+                        isect_db[awy_names[awys[j]]][awy_names[awys[k]]].push_back(
+                            fix_uids[i]);
+                    }
+                }
+            }
+        }
+    }
 }; // namespace libnav
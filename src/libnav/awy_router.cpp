@@ -0,0 +1,223 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for AwyRouter class.
+*/
+
+
+#include <limits>
+#include <queue>
+#include "libnav/awy_router.hpp"
+
+
+namespace libnav
+{
+	// AwyRouter definitions:
+	// Public member functions:
+
+	AwyRouter::AwyRouter(std::shared_ptr<AwyDB> awy_db, std::shared_ptr<NavaidDB> navaid_db)
+	{
+		awy_db_ptr = awy_db;
+		n_unresolved = 0;
+
+		size_t n_nodes = awy_db->get_n_fixes();
+		node_pos.assign(n_nodes, { 0, 0 });
+		is_resolved.assign(n_nodes, false);
+		for (uint32_t i = 0; i < uint32_t(n_nodes); i++)
+		{
+			const waypoint_entry_t* wpt = awy_db->get_fix_wpt(i);
+			if (!awy_db->is_linked())
+			{
+				wpt = navaid_db->find_wpt_by_awy_str(awy_db->get_fix_uid(i));
+			}
+
+			if (wpt == nullptr)
+			{
+				n_unresolved++;
+				continue;
+			}
+			node_pos[i] = wpt->pos;
+			is_resolved[i] = true;
+		}
+
+		edge_start.assign(n_nodes + 1, 0);
+		for (uint32_t i = 0; i < uint32_t(n_nodes); i++)
+		{
+			edge_start[i] = uint32_t(edges.size());
+			if (!is_resolved[i])
+			{
+				continue;
+			}
+			for (auto& e : awy_db->get_fix_edges(i))
+			{
+				if (is_resolved[e.to])
+				{
+					double dist_nm = node_pos[i].get_gc_dist_nm(node_pos[e.to]);
+					edges.push_back({ e.to, e.awy, e.alt_restr, dist_nm });
+				}
+			}
+		}
+		edge_start[n_nodes] = uint32_t(edges.size());
+	}
+
+	size_t AwyRouter::get_n_nodes() const
+	{
+		return node_pos.size();
+	}
+
+	size_t AwyRouter::get_n_edges() const
+	{
+		return edges.size();
+	}
+
+	size_t AwyRouter::get_n_unresolved() const
+	{
+		return n_unresolved;
+	}
+
+	const std::string& AwyRouter::get_node_uid(size_t idx) const
+	{
+		return awy_db_ptr->get_fix_uid(uint32_t(idx));
+	}
+
+	bool AwyRouter::has_fix(const std::string& uid) const
+	{
+		return get_node(uid) != AWY_IDX_NONE;
+	}
+
+	size_t AwyRouter::get_route(const std::string& start, const std::string& end,
+		std::vector<awy_route_leg_t>* out, awy_route_opts_t opts) const
+	{
+		uint32_t start_idx = get_node(start);
+		uint32_t end_idx = get_node(end);
+		if (start_idx == AWY_IDX_NONE || end_idx == AWY_IDX_NONE)
+		{
+			return 0;
+		}
+		if (start_idx == end_idx)
+		{
+			out->push_back({ "", awy_point_t(start), 0 });
+			return out->size();
+		}
+
+		// Search states are edges rather than nodes, so that the cost of changing
+		// the airway depends on the airway the fix was reached by.
+		geo::point end_pos = node_pos[end_idx];
+		std::vector<double> h(node_pos.size(), -1);
+		std::vector<double> g(edges.size(), std::numeric_limits<double>::infinity());
+		std::vector<uint32_t> prev(edges.size(), AWY_IDX_NONE);
+		std::vector<bool> closed(edges.size(), false);
+		std::priority_queue<state_t, std::vector<state_t>, StateCompare> q;
+
+		for (uint32_t i = edge_start[start_idx]; i < edge_start[start_idx + 1]; i++)
+		{
+			const edge_t& e = edges[i];
+			if (is_allowed(e, opts))
+			{
+				geo::point pos = node_pos[e.to];
+				h[e.to] = pos.get_gc_dist_nm(end_pos);
+				g[i] = e.dist_nm;
+				q.push({ g[i] + h[e.to], i });
+			}
+		}
+
+		uint32_t goal = AWY_IDX_NONE;
+		while (q.size())
+		{
+			uint32_t curr = q.top().edge;
+			q.pop();
+			if (closed[curr])
+			{
+				continue;
+			}
+			closed[curr] = true;
+
+			const edge_t& e_curr = edges[curr];
+			if (e_curr.to == end_idx)
+			{
+				goal = curr;
+				break;
+			}
+
+			for (uint32_t i = edge_start[e_curr.to]; i < edge_start[e_curr.to + 1]; i++)
+			{
+				const edge_t& e = edges[i];
+				if (closed[i] || !is_allowed(e, opts))
+				{
+					continue;
+				}
+
+				double cost = g[curr] + e.dist_nm;
+				if (e.awy != e_curr.awy)
+				{
+					cost += opts.awy_change_nm;
+				}
+				if (cost < g[i])
+				{
+					if (h[e.to] < 0)
+					{
+						geo::point pos = node_pos[e.to];
+						h[e.to] = pos.get_gc_dist_nm(end_pos);
+					}
+					g[i] = cost;
+					prev[i] = curr;
+					q.push({ cost + h[e.to], i });
+				}
+			}
+		}
+
+		if (goal == AWY_IDX_NONE)
+		{
+			return 0;
+		}
+
+		size_t n_legs = 1;
+		for (uint32_t i = goal; i != AWY_IDX_NONE; i = prev[i])
+		{
+			n_legs++;
+		}
+
+		size_t base = out->size();
+		out->resize(base + n_legs);
+		size_t pos = base + n_legs - 1;
+		uint32_t first = goal;
+		for (uint32_t i = goal; i != AWY_IDX_NONE; i = prev[i])
+		{
+			const edge_t& e = edges[i];
+			awy_route_leg_t& leg = out->at(pos--);
+			leg.awy = awy_db_ptr->get_awy_name(e.awy);
+			leg.point.id = awy_db_ptr->get_fix_uid(e.to);
+			leg.point.alt_restr = e.alt_restr;
+			leg.dist_nm = e.dist_nm;
+			first = i;
+		}
+		awy_route_leg_t& leg = out->at(base);
+		leg.point.id = start;
+		leg.point.alt_restr = edges[first].alt_restr;
+		leg.dist_nm = 0;
+
+		return out->size();
+	}
+
+	// Private member functions:
+
+	uint32_t AwyRouter::get_node(const std::string& uid) const
+	{
+		uint32_t idx = awy_db_ptr->get_fix_idx(uid);
+		if (idx == AWY_IDX_NONE || !is_resolved[idx])
+		{
+			return AWY_IDX_NONE;
+		}
+		return idx;
+	}
+
+	bool AwyRouter::is_allowed(const edge_t& e, const awy_route_opts_t& opts)
+	{
+		return opts.fl == 0 || (e.alt_restr.lower <= opts.fl && opts.fl <= e.alt_restr.upper);
+	}
+}; // namespace libnav
@@ -0,0 +1,213 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for CifpArchive class.
+*/
+
+
+#include "libnav/cifp_archive.hpp"
+
+
+namespace libnav
+{
+	// CifpArchive definitions:
+	// Public member functions:
+
+	CifpArchive::CifpArchive(std::string path)
+	{
+		airac = 0;
+		err_code = read_archive(path);
+		if (err_code != DbErr::SUCCESS)
+		{
+			data.clear();
+			airports.clear();
+		}
+	}
+
+	DbErr CifpArchive::get_err() const
+	{
+		return err_code;
+	}
+
+	int CifpArchive::get_airac() const
+	{
+		return airac;
+	}
+
+	size_t CifpArchive::get_n_airports() const
+	{
+		return airports.size();
+	}
+
+	bool CifpArchive::is_stale(int airac_cycle) const
+	{
+		return err_code != DbErr::SUCCESS || airac != airac_cycle;
+	}
+
+	bool CifpArchive::get_airport(const std::string& icao, const char** out,
+		size_t* out_sz) const
+	{
+		auto it = airports.find(icao);
+		if (it == airports.end())
+		{
+			return false;
+		}
+
+		*out = data.data() + it->second.offset;
+		*out_sz = size_t(it->second.size);
+		return true;
+	}
+
+	DbErr CifpArchive::compile(std::string out_path, std::shared_ptr<ArptDB> arpt_db,
+		std::string cifp_path, std::string postfix, int airac_cycle, size_t* n_written)
+	{
+		std::vector<std::string> icaos;
+		for (auto& it : arpt_db->get_arpt_db())
+		{
+			icaos.push_back(it.first);
+		}
+		// Keeps the output deterministic
+		std::sort(icaos.begin(), icaos.end());
+
+		std::vector<std::string> found;
+		std::vector<std::string> contents;
+		for (auto& it : icaos)
+		{
+			if (it.size() > CIFP_ARCHIVE_ICAO_SZ)
+				continue;
+
+			std::ifstream file(cifp_path + "/" + it + postfix, std::ifstream::binary);
+			if (file.is_open())
+			{
+				std::stringstream s;
+				s << file.rdbuf();
+				found.push_back(it);
+				contents.push_back(s.str());
+			}
+		}
+
+		std::string tmp_path = out_path + ".tmp";
+		std::ofstream out(tmp_path, std::ofstream::binary);
+		if (!out.is_open())
+		{
+			return DbErr::FILE_NOT_FOUND;
+		}
+
+		out.write(CIFP_ARCHIVE_SIGN.c_str(), std::streamsize(CIFP_ARCHIVE_SIGN.size()));
+		write_val(out, CIFP_ARCHIVE_VERSION);
+		write_val(out, CIFP_ARCHIVE_BOM);
+		write_val(out, int32_t(airac_cycle));
+		write_val(out, uint32_t(found.size()));
+
+		uint64_t offset = 0;
+		for (size_t i = 0; i < found.size(); i++)
+		{
+			char icao[CIFP_ARCHIVE_ICAO_SZ] = {};
+			std::memcpy(icao, found[i].c_str(), found[i].size());
+			out.write(icao, CIFP_ARCHIVE_ICAO_SZ);
+			write_val(out, offset);
+			write_val(out, uint64_t(contents[i].size()));
+			offset += contents[i].size();
+		}
+		for (auto& it : contents)
+		{
+			out.write(it.c_str(), std::streamsize(it.size()));
+		}
+
+		out.close();
+		if (!out.good())
+		{
+			std::remove(tmp_path.c_str());
+			return DbErr::FILE_NOT_FOUND;
+		}
+
+		std::remove(out_path.c_str());
+		if (std::rename(tmp_path.c_str(), out_path.c_str()) != 0)
+		{
+			std::remove(tmp_path.c_str());
+			return DbErr::FILE_NOT_FOUND;
+		}
+
+		if (n_written != nullptr)
+		{
+			*n_written = found.size();
+		}
+		return DbErr::SUCCESS;
+	}
+
+	// Private member functions:
+
+	DbErr CifpArchive::read_archive(std::string& path)
+	{
+		std::ifstream file(path, std::ifstream::binary | std::ifstream::ate);
+		if (!file.is_open())
+		{
+			return DbErr::FILE_NOT_FOUND;
+		}
+
+		std::streamoff file_sz = file.tellg();
+		if (file_sz < 0)
+		{
+			return DbErr::DATA_BASE_ERROR;
+		}
+		data.resize(size_t(file_sz));
+		file.seekg(0);
+		file.read(data.data(), std::streamsize(data.size()));
+		if (!file.good())
+		{
+			return DbErr::DATA_BASE_ERROR;
+		}
+
+		size_t sign_sz = CIFP_ARCHIVE_SIGN.size();
+		if (data.size() < sign_sz ||
+			std::memcmp(data.data(), CIFP_ARCHIVE_SIGN.c_str(), sign_sz) != 0)
+		{
+			return DbErr::DATA_BASE_ERROR;
+		}
+
+		size_t pos = sign_sz;
+		uint32_t version, bom, n_apts;
+		int32_t cycle;
+		if (!read_val(data, &pos, &version) || version != CIFP_ARCHIVE_VERSION ||
+			!read_val(data, &pos, &bom) || bom != CIFP_ARCHIVE_BOM ||
+			!read_val(data, &pos, &cycle) || !read_val(data, &pos, &n_apts))
+		{
+			return DbErr::DATA_BASE_ERROR;
+		}
+		airac = int(cycle);
+
+		size_t table_sz = size_t(n_apts) * (CIFP_ARCHIVE_ICAO_SZ + 2 * sizeof(uint64_t));
+		if (data.size() < pos + table_sz)
+		{
+			return DbErr::DATA_BASE_ERROR;
+		}
+		size_t records_start = pos + table_sz;
+		uint64_t records_sz = uint64_t(data.size() - records_start);
+
+		airports.reserve(n_apts);
+		for (uint32_t i = 0; i < n_apts; i++)
+		{
+			const char* icao = data.data() + pos;
+			pos += CIFP_ARCHIVE_ICAO_SZ;
+
+			apt_span_t span;
+			read_val(data, &pos, &span.offset);
+			read_val(data, &pos, &span.size);
+			if (span.offset > records_sz || span.size > records_sz - span.offset)
+			{
+				return DbErr::DATA_BASE_ERROR;
+			}
+			span.offset += records_start;
+
+			const char* icao_end = std::find(icao, icao + CIFP_ARCHIVE_ICAO_SZ, '\0');
+			airports[std::string(icao, size_t(icao_end - icao))] = span;
+		}
+
+		return DbErr::SUCCESS;
+	}
+}; // namespace libnav
@@ -66,11 +66,12 @@ namespace libnav
         }
     }
 
-    float str2rnp(std::string s)
+    float str2rnp(const std::string& s)
     {
         if(s.length() == 3)
         {
-            float num = float(atof(s.substr(0, 2).c_str()));
+            const char* c = s.c_str();
+            float num = float(strutils::prefix_to_double(c, c + 2));
             int exp = s[2] - '0';
 
             if(exp != 0)
@@ -83,34 +84,36 @@ namespace libnav
         return 0;
     }
 
-    float str2outbd_crs(std::string s, bool* is_true)
+    float str2outbd_crs(const std::string& s, bool* is_true)
     {
         *is_true = false;
 
         if(s.length() == 4)
         {
+            const char* c = s.c_str();
             if(s[3] == 'T')
             {
                 *is_true = true;
-                return float(atof(s.substr(0, 3).c_str()));
+                return float(strutils::prefix_to_double(c, c + 3));
             }
-            return float(atof(s.c_str()) * 0.1);
+            return float(strutils::prefix_to_double(c, c + 4) * 0.1);
         }
         return 0;
     }
 
-    float str2outbd_dist(std::string s, bool* as_time)
+    float str2outbd_dist(const std::string& s, bool* as_time)
     {
         *as_time = false;
 
         if(s.length() == 4)
         {
+            const char* c = s.c_str();
             if(s[0] == 'T')
             {
                 *as_time = true;
-                return float(atof(s.substr(1, 3).c_str()) * 0.1);
+                return float(strutils::prefix_to_double(c + 1, c + 4) * 0.1);
             }
-            return float(atof(s.c_str()) * 0.1);
+            return float(strutils::prefix_to_double(c, c + 4) * 0.1);
         }
         return 0;
     }
@@ -146,24 +149,22 @@ namespace libnav
         }
     }
 
-    int str2alt(std::string s)
+    int str2alt(const std::string& s)
     {
         if(s.length() == 5)
         {
+            const char* c = s.c_str();
+            int out = 0;
             if(s[0] == 'F' && s[1] == 'L')
             {
-                std::string num_part = s.substr(2, 3);
-                if(strutils::is_numeric(num_part))
+                if(strutils::field_to_int(c + 2, c + 5, &out, 0))
                 {
-                    return stoi(num_part) * 100;
+                    return out * 100;
                 }
             }
-            else
+            else if(strutils::field_to_int(c, c + 5, &out, 0))
             {
-                if(strutils::is_numeric(s))
-                {
-                    return stoi(s);
-                }
+                return out;
             }
         }
 
@@ -230,7 +231,44 @@ namespace libnav
 
     // arinc_fix_entry_t definitions:
 
+    std::string arinc_fix_entry_t::get_memo_key()
+    {
+        std::string out = fix_ident;
+        out.push_back(' ');
+        out.append(country_code);
+        out.push_back(' ');
+        out.push_back(db_section);
+        out.push_back(db_subsection);
+        return out;
+    }
+
     bool arinc_fix_entry_t::to_waypoint_t(std::string& area_code, 
+        std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
+        arinc_rwy_db_t& rwy_db, waypoint_t *out, fix_memo_t* memo)
+    {
+        if(memo == nullptr)
+        {
+            return lookup_waypoint(area_code, arpt_db, navaid_db, rwy_db, out);
+        }
+
+        std::string key = get_memo_key();
+        auto it = memo->find(key);
+        if(it == memo->end())
+        {
+            fix_memo_entry_t tmp;
+            tmp.is_found = lookup_waypoint(area_code, arpt_db, navaid_db, rwy_db, 
+                &tmp.wpt);
+            it = memo->emplace(key, tmp).first;
+        }
+
+        if(it->second.is_found)
+        {
+            *out = it->second.wpt;
+        }
+        return it->second.is_found;
+    }
+
+    bool arinc_fix_entry_t::lookup_waypoint(std::string& area_code, 
         std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
         arinc_rwy_db_t& rwy_db, waypoint_t *out)
     {
@@ -380,17 +418,70 @@ namespace libnav
         rt_qual2 = in_split[37][0];
     }
 
+    arinc_str_t::arinc_str_t(const char* line, const strutils::str_span_t* cols)
+    {
+        rt_type = strutils::span_first(line, cols[1]);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[2]), &proc_name);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[3]), &trans_name);
+
+        strutils::span_to_str(line, cols[4], &main_fix.fix_ident);
+        strutils::span_to_str(line, cols[5], &main_fix.country_code);
+        main_fix.db_section = strutils::span_first(line, cols[6]);
+        main_fix.db_subsection = strutils::span_first(line, cols[7]);
+        strutils::span_to_str(line, cols[8], &wpt_desc);
+
+        turn_dir = strutils::span_first(line, cols[9]);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[10]), &rnp);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[11]), &leg_type);
+        tdv = strutils::span_first(line, cols[12]);
+
+        strutils::span_to_str(line, strutils::strip_span(line, cols[13]), 
+            &recd_navaid.fix_ident);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[14]), 
+            &recd_navaid.country_code);
+        recd_navaid.db_section = strutils::span_first(line, cols[15]);
+        recd_navaid.db_subsection = strutils::span_first(line, cols[16]);
+
+        arc_radius = double(strutils::span_to_float(line, cols[17]));
+        theta = double(strutils::span_to_float(line, cols[18]));
+        rho = double(strutils::span_to_float(line, cols[19]));
+        strutils::span_to_str(line, strutils::strip_span(line, cols[20]), &outbd_mag_crs);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[21]), &outbd_dist_time);
+
+        alt_desc = strutils::span_first(line, cols[22]);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[23]), &alt1);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[24]), &alt2);
+        trans_alt = strutils::span_to_int(line, cols[25]);
+
+        speed_desc = strutils::span_first(line, cols[26]);
+        spd_lim = strutils::span_to_int(line, cols[27]);
+        vert_angle = double(strutils::span_to_float(line, cols[28]) * 0.01);
+        vert_scale = strutils::span_to_int(line, cols[29]);
+
+        strutils::span_to_str(line, strutils::strip_span(line, cols[30]), 
+            &center_fix.fix_ident);
+        strutils::span_to_str(line, strutils::strip_span(line, cols[31]), 
+            &center_fix.country_code);
+        center_fix.db_section = strutils::span_first(line, cols[32]);
+        center_fix.db_subsection = strutils::span_first(line, cols[33]);
+
+        multi_cod = strutils::span_first(line, cols[34]);
+        gnss_ind = strutils::span_first(line, cols[35]);
+        rt_qual1 = strutils::span_first(line, cols[36]);
+        rt_qual2 = strutils::span_first(line, cols[37]);
+    }
+
     // arinc_leg_t definitions:
 
     arinc_leg_t arinc_str_t::get_leg(std::string& area_code, airport_data_t& apt_data, 
         std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
-        arinc_rwy_db_t& rwy_db)
+        arinc_rwy_db_t& rwy_db, fix_memo_t* memo)
     {
         arinc_leg_t out;
         out.rt_type = rt_type;
 
         out.has_main_fix = main_fix.to_waypoint_t(area_code, arpt_db, navaid_db, 
-            rwy_db, &out.main_fix);
+            rwy_db, &out.main_fix, memo);
 
         out.wpt_desc = wpt_desc;
         out.turn_dir = char2dir(turn_dir);
@@ -399,12 +490,13 @@ namespace libnav
         out.is_ovfy = tdv == 'Y';
 
         out.has_recd_navaid = recd_navaid.to_waypoint_t(area_code, arpt_db, navaid_db, 
-            rwy_db, &out.recd_navaid);
+            rwy_db, &out.recd_navaid, memo);
         out.arc_radius = arc_radius;
         out.theta = theta * 0.1;
         if(theta != 0 && out.has_recd_navaid && out.has_main_fix)
         {
-            out.tru_theta = out.recd_navaid.data.pos.get_gc_bearing_rad(
+            geo::point navaid_pos = out.recd_navaid.data.pos;
+            out.tru_theta = navaid_pos.get_gc_bearing_rad(
                 out.main_fix.data.pos) * geo::RAD_TO_DEG;
             
             if(out.tru_theta < 0)
@@ -429,7 +521,7 @@ namespace libnav
         out.vert_scale_ft = vert_scale;
 
         out.has_center_fix = center_fix.to_waypoint_t(area_code, arpt_db, navaid_db, 
-            rwy_db, &out.center_fix);
+            rwy_db, &out.center_fix, memo);
 
         out.multi_cod = multi_cod;
         out.gnss_ind = gnss_ind;
@@ -456,17 +548,21 @@ namespace libnav
         return ret;
     }
 
-    void arinc_rwy_full_t::get_rwy_coords(std::string& s, std::string& area_code, 
-        std::shared_ptr<ArptDB> arpt_db)
+    void arinc_rwy_full_t::get_rwy_coords(const char* s, size_t s_len, 
+        std::string& area_code, std::shared_ptr<ArptDB> arpt_db)
     {
-        std::vector<std::string> second_part_splt = strutils::str_split(
-            s, ARINC_FIELD_SEP);
+        strutils::str_span_t second_part_splt[N_ARINC_RWY_COL_SECOND];
+        size_t n_cols = strutils::str_split_spans(s, s_len, ARINC_FIELD_SEP, 
+            second_part_splt, N_ARINC_RWY_COL_SECOND);
         
-        if(second_part_splt.size() == N_ARINC_RWY_COL_SECOND)
+        if(n_cols == N_ARINC_RWY_COL_SECOND)
         {
-            std::string lat_stripped = strutils::strip(second_part_splt[0], ' ');
-            std::string lon_stripped = strutils::strip(second_part_splt[1], ' ');
-            data.thresh_displ_ft = strutils::stoi_with_strip(second_part_splt[2]);
+            std::string lat_stripped, lon_stripped;
+            strutils::span_to_str(s, strutils::strip_span(s, second_part_splt[0]), 
+                &lat_stripped);
+            strutils::span_to_str(s, strutils::strip_span(s, second_part_splt[1]), 
+                &lon_stripped);
+            data.thresh_displ_ft = strutils::span_to_int(s, second_part_splt[2]);
 
             data.pos.lat_rad = strutils::str_to_lat(lat_stripped) * geo::DEG_TO_RAD;
             data.pos.lon_rad = strutils::str_to_lon(lon_stripped) * geo::DEG_TO_RAD;
@@ -498,15 +594,36 @@ namespace libnav
         */
         err = DbErr::SUCCESS;
 
-        std::vector<std::string> main_parts = strutils::str_split(s, ';');
-        std::vector<std::string> first_part_splt = strutils::str_split(
-            main_parts[0], ARINC_FIELD_SEP);
-        std::vector<std::string> name_part = strutils::str_split(
-            first_part_splt[0], ':');
+        // Columns of every part are relative to the start of that part
+        const char* line = s.c_str();
+        strutils::str_span_t main_parts[2];
+        size_t n_main = strutils::str_split_spans(line, s.length(), ';', main_parts, 2);
+        if(n_main == 0)
+        {
+            err = DbErr::DATA_BASE_ERROR;
+            return;
+        }
+
+        const char* first_part = line + main_parts[0].pos;
+        strutils::str_span_t first_part_splt[N_ARINC_RWY_COL_FIRST];
+        size_t n_first = strutils::str_split_spans(first_part, main_parts[0].len, 
+            ARINC_FIELD_SEP, first_part_splt, N_ARINC_RWY_COL_FIRST);
+        
+        const char* name = first_part;
+        strutils::str_span_t name_part[2];
+        size_t n_name = 0;
+        if(n_first)
+        {
+            name += first_part_splt[0].pos;
+            n_name = strutils::str_split_spans(name, first_part_splt[0].len, ':', 
+                name_part, 2);
+        }
         
-        if(name_part.size() > 1 && first_part_splt.size() == N_ARINC_RWY_COL_FIRST)
+        if(n_name > 1 && n_first == N_ARINC_RWY_COL_FIRST)
         {
-            std::string curr_id = strutils::strip(name_part[1], ' ');
+            std::string curr_id;
+            strutils::span_to_str(name, strutils::strip_span(name, name_part[1]), 
+                &curr_id);
             size_t id_length = curr_id.length();
             if(id_length > 2 && curr_id[0] == 'R' && 
                 curr_id[1] == 'W' && isdigit(curr_id[2]))
@@ -519,14 +636,20 @@ namespace libnav
                 return;
             }
 
-            data.grad_deg = float(strutils::stof_with_strip(first_part_splt[1]) * 0.001);
-            data.ellips_height_m = float(strutils::stof_with_strip(first_part_splt[2]) * 0.1);
-            data.thresh_elev_msl_ft = strutils::stoi_with_strip(first_part_splt[3]);
-
-            data.tch_tp = char2tch_type(first_part_splt[4][0]);
-            data.ls_ident = strutils::strip(first_part_splt[5], ' ');
-            data.ls_cat = char2ls_category(first_part_splt[6][0]);
-            data.tch_ft = strutils::stoi_with_strip(first_part_splt[7]);
+            data.grad_deg = float(strutils::span_to_float(first_part, 
+                first_part_splt[1]) * 0.001);
+            data.ellips_height_m = float(strutils::span_to_float(first_part, 
+                first_part_splt[2]) * 0.1);
+            data.thresh_elev_msl_ft = strutils::span_to_int(first_part, 
+                first_part_splt[3]);
+
+            data.tch_tp = char2tch_type(strutils::span_first(first_part, 
+                first_part_splt[4]));
+            strutils::span_to_str(first_part, strutils::strip_span(first_part, 
+                first_part_splt[5]), &data.ls_ident);
+            data.ls_cat = char2ls_category(strutils::span_first(first_part, 
+                first_part_splt[6]));
+            data.tch_ft = strutils::span_to_int(first_part, first_part_splt[7]);
         }
         else
         {
@@ -534,13 +657,15 @@ namespace libnav
             return;
         }
 
-        std::string pos_str = "";
-        if(main_parts.size() == 2)
+        if(n_main == 2)
         {
-            pos_str = main_parts[1];
+            get_rwy_coords(line + main_parts[1].pos, main_parts[1].len, area_code, 
+                arpt_db);
+        }
+        else
+        {
+            get_rwy_coords(line, 0, area_code, arpt_db);
         }
-
-        get_rwy_coords(pos_str, area_code, arpt_db);
     }
 
 
@@ -622,11 +747,24 @@ namespace libnav
 
     // Airport class definitions
 
+    std::mutex Airport::async_load_mutex;
+    std::unordered_map<std::string, std::shared_ptr<Airport::async_load_t>> 
+        Airport::async_loads;
+
     // public member functions:
 
     Airport::Airport(std::string icao, std::shared_ptr<ArptDB> arpt_db, 
         std::shared_ptr<NavaidDB> navaid_db, std::string cifp_path,
-        std::string postfix, bool use_pr, appr_pref_db_t pr_db, arinc_leg_t* leg_ptr)
+        std::string postfix, bool use_pr, appr_pref_db_t pr_db, arinc_leg_t* leg_ptr):
+        Airport(icao, arpt_db, navaid_db, std::shared_ptr<const CifpArchive>(), 
+            cifp_path, postfix, use_pr, pr_db, leg_ptr)
+    {
+    }
+
+    Airport::Airport(std::string icao, std::shared_ptr<ArptDB> arpt_db, 
+        std::shared_ptr<NavaidDB> navaid_db, std::shared_ptr<const CifpArchive> archive, 
+        std::string cifp_path, std::string postfix, bool use_pr, appr_pref_db_t pr_db, 
+        arinc_leg_t* leg_ptr)
     {
         use_appch_prefix = use_pr;
         appch_prefix_db = pr_db;
@@ -655,7 +793,19 @@ namespace libnav
         }
         else
         {
-            err_code = load_db(arpt_db, navaid_db, cifp_path, postfix);
+            const char* apt_records;
+            size_t apt_records_sz;
+            if(archive != nullptr && !archive->is_stale(navaid_db->get_wpt_cycle()) && 
+                archive->get_airport(icao_code, &apt_records, &apt_records_sz))
+            {
+                err_code = load_archive(arpt_db, navaid_db, apt_records, apt_records_sz);
+            }
+            else
+            {
+                err_code = load_db(arpt_db, navaid_db, cifp_path, postfix);
+            }
+            // Legs are only added during the load
+            trim_legs();
         }
     }
 
@@ -698,86 +848,178 @@ namespace libnav
         star_per_rwy = copy.star_per_rwy;
     }
 
-    std::vector<std::string> Airport::get_rwys()
+    airport_future_t Airport::load_async(std::string icao, 
+        std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
+        std::string cifp_path, std::string postfix, bool use_pr, 
+        appr_pref_db_t pr_db, airport_cb_t on_done, std::shared_ptr<Executor> exec, 
+        std::shared_ptr<const CifpArchive> archive)
+    {
+        std::string key = get_load_key(icao, arpt_db.get(), navaid_db.get(), 
+            archive.get(), cifp_path, postfix, use_pr);
+
+        std::shared_ptr<async_load_t> load;
+        std::shared_ptr<std::promise<airport_ptr_t>> done;
+        {
+            std::lock_guard<std::mutex> lock(async_load_mutex);
+            auto it = async_loads.find(key);
+            if(it != async_loads.end())
+            {
+                // Someone is already loading this airport. Just wait for it.
+                if(on_done != nullptr)
+                {
+                    it->second->callbacks.push_back(on_done);
+                }
+                return it->second->future;
+            }
+
+            done = std::make_shared<std::promise<airport_ptr_t>>();
+            load = std::make_shared<async_load_t>();
+            load->future = done->get_future().share();
+            if(on_done != nullptr)
+            {
+                load->callbacks.push_back(on_done);
+            }
+            async_loads[key] = load;
+        }
+
+        if(exec == nullptr)
+        {
+            exec = get_default_executor();
+        }
+
+        exec->submit([=]() {
+            airport_ptr_t apt = nullptr;
+            try
+            {
+                apt = std::make_shared<Airport>(icao, arpt_db, navaid_db, archive, 
+                    cifp_path, postfix, use_pr, pr_db);
+                done->set_value(apt);
+            }
+            catch(...)
+            {
+                done->set_exception(std::current_exception());
+            }
+
+            // Nobody can add callbacks once the load is out of the map.
+            std::vector<airport_cb_t> callbacks;
+            {
+                std::lock_guard<std::mutex> lock(async_load_mutex);
+                async_loads.erase(key);
+                callbacks.swap(load->callbacks);
+            }
+            for(auto& it: callbacks)
+            {
+                it(apt);
+            }
+        });
+
+        return load->future;
+    }
+
+    std::vector<std::string> Airport::get_rwys() const
     {
         std::vector<std::string> out;
-        for(auto i: rwy_db)
+        for(auto& i: rwy_db)
         {
             out.push_back(i.first);
         }
         return out;
     }
 
-    const arinc_rwy_db_t& Airport::get_rwy_db()
+    const arinc_rwy_db_t& Airport::get_rwy_db() const
     {
         return rwy_db;
     }
 
-    str_umap_t Airport::get_all_sids()
+    str_umap_t Airport::get_all_sids() const
     {
         return get_all_proc(sid_db);
     }
 
-    str_umap_t Airport::get_all_stars()
+    str_umap_t Airport::get_all_stars() const
     {
         return get_all_proc(star_db);
     }
 
-    str_umap_t Airport::get_all_appch()
+    str_umap_t Airport::get_all_appch() const
     {
         return get_all_proc(appch_db);
     }
 
-    arinc_leg_seq_t Airport::get_sid(std::string& proc_name, std::string& trans)
+    arinc_leg_seq_t Airport::get_sid(const std::string& proc_name, 
+        const std::string& trans) const
     {
         return get_proc(proc_name, trans, sid_db);
     }
 
-    arinc_leg_seq_t Airport::get_star(std::string& proc_name, std::string& trans)
+    arinc_leg_seq_t Airport::get_star(const std::string& proc_name, 
+        const std::string& trans) const
     {
         return get_proc(proc_name, trans, star_db);
     }
 
-    arinc_leg_seq_t Airport::get_appch(std::string& proc_name, std::string& trans)
+    arinc_leg_seq_t Airport::get_appch(const std::string& proc_name, 
+        const std::string& trans) const
     {
         return get_proc(proc_name, trans, appch_db);
     }
 
-    str_set_t Airport::get_sid_by_rwy(std::string& rwy_id)
+    str_set_t Airport::get_sid_by_rwy(const std::string& rwy_id) const
     {
         return get_proc_by_rwy(rwy_id, sid_per_rwy);
     }
 
-    str_set_t Airport::get_star_by_rwy(std::string& rwy_id)
+    str_set_t Airport::get_star_by_rwy(const std::string& rwy_id) const
     {
         return get_proc_by_rwy(rwy_id, star_per_rwy);
     }
 
-    str_set_t Airport::get_rwy_by_sid(std::string& sid)
+    str_set_t Airport::get_rwy_by_sid(const std::string& sid) const
     {
         return get_trans_by_proc(sid, sid_db, true);
     }
 
-    str_set_t Airport::get_rwy_by_star(std::string& star)
+    str_set_t Airport::get_rwy_by_star(const std::string& star) const
     {
         return get_trans_by_proc(star, star_db, true);
     }
 
-    str_set_t Airport::get_trans_by_sid(std::string& sid)
+    str_set_t Airport::get_trans_by_sid(const std::string& sid) const
     {
         return get_trans_by_proc(sid, sid_db);
     }
 
-    str_set_t Airport::get_trans_by_star(std::string& star)
+    str_set_t Airport::get_trans_by_star(const std::string& star) const
     {
         return get_trans_by_proc(star, star_db);
     }
 
-    str_set_t Airport::get_trans_by_appch(std::string& appch)
+    str_set_t Airport::get_trans_by_appch(const std::string& appch) const
     {
         return get_trans_by_proc(appch, appch_db);
     }
 
+    size_t Airport::get_mem_usage() const
+    {
+        size_t out = sizeof(Airport);
+        out += size_t(n_arinc_legs_used) * sizeof(arinc_leg_t);
+        out += get_proc_db_mem(sid_db) + get_proc_db_mem(star_db) + 
+            get_proc_db_mem(appch_db);
+        for(auto& i: rwy_db)
+        {
+            out += sizeof(i) + i.first.capacity();
+        }
+        for(auto& i: sid_per_rwy)
+        {
+            out += sizeof(i) + i.second.size() * sizeof(std::string);
+        }
+        for(auto& i: star_per_rwy)
+        {
+            out += sizeof(i) + i.second.size() * sizeof(std::string);
+        }
+        return out;
+    }
+
     Airport::~Airport()
     {
         if(arinc_legs != nullptr && self_alloc)
@@ -788,12 +1030,24 @@ namespace libnav
 
     // private member functions:
 
-    str_umap_t Airport::get_all_proc(proc_db_t& db)
+    std::string Airport::get_load_key(std::string& icao, ArptDB* arpt_db, 
+        NavaidDB* navaid_db, const CifpArchive* archive, std::string& cifp_path, 
+        std::string& postfix, bool use_pr)
+    {
+        std::stringstream s;
+        s << icao << " " << static_cast<void*>(arpt_db) << " " << 
+            static_cast<void*>(navaid_db) << " " << 
+            static_cast<const void*>(archive) << " " << use_pr << " " << cifp_path << 
+            postfix;
+        return s.str();
+    }
+
+    str_umap_t Airport::get_all_proc(const proc_db_t& db) const
     {
         str_umap_t out;
-        for(auto i: db)
+        for(auto& i: db)
         {
-            for(auto j: i.second)
+            for(auto& j: i.second)
             {
                 out[i.first].insert(j.first);
             }
@@ -802,18 +1056,20 @@ namespace libnav
         return out;
     }
 
-    arinc_leg_seq_t Airport::get_proc(std::string& proc_name, std::string& trans, 
-        proc_db_t& db)
+    arinc_leg_seq_t Airport::get_proc(const std::string& proc_name, 
+        const std::string& trans, const proc_db_t& db) const
     {
-        if(db.find(proc_name) != db.end())
+        auto proc_it = db.find(proc_name);
+        if(proc_it != db.end())
         {
-            if(db[proc_name].find(trans) != db[proc_name].end())
+            auto trans_it = proc_it->second.find(trans);
+            if(trans_it != proc_it->second.end())
             {
                 arinc_leg_seq_t proc_legs;
 
-                for(size_t i = 0; i < db[proc_name][trans].size(); i++)
+                for(size_t i = 0; i < trans_it->second.size(); i++)
                 {
-                    int leg_idx = db[proc_name][trans][i];
+                    int leg_idx = trans_it->second[i];
                     proc_legs.push_back(arinc_legs[leg_idx]);
                 }
 
@@ -823,26 +1079,28 @@ namespace libnav
         return {};
     }
 
-    str_set_t Airport::get_proc_by_rwy(std::string& rwy_id, 
-        str_umap_t& umap)
+    str_set_t Airport::get_proc_by_rwy(const std::string& rwy_id, 
+        const str_umap_t& umap) const
     {
-        if(umap.find(rwy_id) != umap.end())
+        auto it = umap.find(rwy_id);
+        if(it != umap.end())
         {
             // Case: runway was found
-            return umap[rwy_id];
+            return it->second;
         }
 
         return {};
     }
 
-    str_set_t Airport::get_trans_by_proc(std::string& proc_name, 
-        proc_db_t db, bool rwy)
+    str_set_t Airport::get_trans_by_proc(const std::string& proc_name, 
+        const proc_db_t& db, bool rwy) const
     {
         str_set_t out;
 
-        if(db.find(proc_name) != db.end())
+        auto proc_it = db.find(proc_name);
+        if(proc_it != db.end())
         {
-            for(auto i: db[proc_name])
+            for(auto& i: proc_it->second)
             {
                 if(rwy_db.find(i.first) != rwy_db.end() && rwy)
                 {
@@ -858,10 +1116,45 @@ namespace libnav
         return out;
     }
 
+    size_t Airport::get_proc_db_mem(const proc_db_t& db)
+    {
+        size_t out = 0;
+        for(auto& i: db)
+        {
+            out += sizeof(i) + i.first.capacity();
+            for(auto& j: i.second)
+            {
+                out += sizeof(j) + j.first.capacity() + 
+                    j.second.capacity() * sizeof(int);
+            }
+        }
+        return out;
+    }
+
+    void Airport::trim_legs()
+    {
+        if(!self_alloc || arinc_legs == nullptr || 
+            n_arinc_legs_used >= N_FLT_LEG_CACHE_SZ)
+        {
+            return;
+        }
+
+        arinc_leg_t* tmp = new arinc_leg_t[size_t(n_arinc_legs_used)];
+        for(int i = 0; i < n_arinc_legs_used; i++)
+        {
+            tmp[i] = arinc_legs[i];
+        }
+        delete[] arinc_legs;
+        arinc_legs = tmp;
+    }
+
     DbErr Airport::parse_flt_legs(std::shared_ptr<ArptDB> arpt_db, 
         std::shared_ptr<NavaidDB> navaid_db)
     {
         DbErr out = DbErr::SUCCESS;
+        // The same fixes show up in many transitions of an airport
+        fix_memo_t fix_memo;
+        strutils::str_span_t cols[N_ARINC_FLT_PROC_COL];
         while(flt_leg_strings.size())
         {
             proc_typed_str_t curr = flt_leg_strings.front();
@@ -869,20 +1162,20 @@ namespace libnav
 
             if(curr.second != ProcType::PRDAT)
             {
-                std::vector<std::string> s_split = strutils::str_split(curr.first, 
-                    ARINC_FIELD_SEP);
+                size_t n_cols = strutils::str_split_spans(curr.first.c_str(), 
+                    curr.first.length(), ARINC_FIELD_SEP, cols, N_ARINC_FLT_PROC_COL);
 
-                if(s_split.size() == N_ARINC_FLT_PROC_COL)
+                if(n_cols == N_ARINC_FLT_PROC_COL)
                 {
-                    std::string proc_name = strutils::strip(s_split[2], ' ');
-                    std::string trans_name = strutils::strip(s_split[3], ' ');
+                    arinc_str_t arnc_str(curr.first.c_str(), cols);
+                    std::string& proc_name = arnc_str.proc_name;
+                    std::string& trans_name = arnc_str.trans_name;
 
                     if(trans_name == "")
                         trans_name = NONE_TRANS;
 
-                    arinc_str_t arnc_str(s_split);
                     arinc_leg_t leg = arnc_str.get_leg(icao_code, apt_data, arpt_db, 
-                        navaid_db, rwy_db);
+                        navaid_db, rwy_db, &fix_memo);
 
                     if(n_arinc_legs_used == N_FLT_LEG_CACHE_SZ)
                     {
@@ -961,22 +1254,10 @@ namespace libnav
             std::string line;
 			while (getline(file, line))
             {
-                ProcType curr_tp = str2proc_type(line);
-
-                if(curr_tp != ProcType::RWY)
+                DbErr err = add_record(line, arpt_db);
+                if(err != DbErr::SUCCESS)
                 {
-                    proc_typed_str_t tmp = std::make_pair(line, curr_tp);
-                    flt_leg_strings.push(tmp);
-                }
-                else
-                {
-                    arinc_rwy_full_t rwy(line, icao_code, arpt_db);
-
-                    if(rwy.err != DbErr::SUCCESS)
-                    {
-                        return DbErr::DATA_BASE_ERROR;
-                    }
-                    rwy_db[rwy.id] = rwy.data;
+                    return err;
                 }
             }
             file.close();
@@ -987,4 +1268,52 @@ namespace libnav
             return DbErr::FILE_NOT_FOUND;
         }
     }
+
+    DbErr Airport::load_archive(std::shared_ptr<ArptDB> arpt_db, 
+        std::shared_ptr<NavaidDB> navaid_db, const char* data, size_t sz)
+    {
+        // Splits the records the same way getline does
+        std::string line;
+        const char* end = data + sz;
+        while(data < end)
+        {
+            const char* line_end = static_cast<const char*>(
+                std::memchr(data, '\n', size_t(end - data)));
+            if(line_end == nullptr)
+            {
+                line_end = end;
+            }
+            line.assign(data, line_end);
+
+            DbErr err = add_record(line, arpt_db);
+            if(err != DbErr::SUCCESS)
+            {
+                return err;
+            }
+            data = line_end + 1;
+        }
+        return parse_flt_legs(arpt_db, navaid_db);
+    }
+
+    DbErr Airport::add_record(std::string& line, std::shared_ptr<ArptDB> arpt_db)
+    {
+        ProcType curr_tp = str2proc_type(line);
+
+        if(curr_tp != ProcType::RWY)
+        {
+            proc_typed_str_t tmp = std::make_pair(line, curr_tp);
+            flt_leg_strings.push(tmp);
+        }
+        else
+        {
+            arinc_rwy_full_t rwy(line, icao_code, arpt_db);
+
+            if(rwy.err != DbErr::SUCCESS)
+            {
+                return DbErr::DATA_BASE_ERROR;
+            }
+            rwy_db[rwy.id] = rwy.data;
+        }
+        return DbErr::SUCCESS;
+    }
 }; // namespace libnav
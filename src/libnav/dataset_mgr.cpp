@@ -0,0 +1,254 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for DatasetManager class.
+*/
+
+
+#include "libnav/dataset_mgr.hpp"
+
+
+namespace libnav
+{
+	// DatasetManager definitions:
+	// Public member functions:
+
+	DatasetManager::DatasetManager(std::shared_ptr<Executor> exec)
+	{
+		executor = exec;
+		if (executor == nullptr)
+		{
+			executor = get_default_executor();
+		}
+
+		next_generation.store(1);
+		n_pending = 0;
+	}
+
+	dataset_ptr_t DatasetManager::get_current()
+	{
+		return std::atomic_load(&curr_dataset);
+	}
+
+	uint64_t DatasetManager::get_generation()
+	{
+		dataset_ptr_t curr = get_current();
+		if (curr != nullptr)
+		{
+			return curr->generation;
+		}
+		return 0;
+	}
+
+	std::future<DbErr> DatasetManager::load(dataset_paths_t paths)
+	{
+		std::shared_ptr<Executor> exec = executor;
+		// A generation must not be destroyed by a reader or from inside one of its
+		// own load tasks. The deleter waits until every task of the generation is
+		// done and then destroys it on the executor.
+		std::shared_ptr<dataset_t> ds(new dataset_t, [exec](dataset_t* p) {
+			when_all_ready(get_phases(*p, true), [exec, p]() {
+				exec->submit([p]() { delete p; });
+			});
+		});
+
+		ds->generation = next_generation.fetch_add(1);
+		ds->paths = paths;
+		ds->arpt_db = std::make_shared<ArptDB>(paths.apt_dat, paths.custom_apt,
+			paths.custom_rnw, paths.min_rwy_length_m, executor);
+		ds->navaid_db = std::make_shared<NavaidDB>(paths.fix_data, paths.navaid_data,
+			executor);
+		ds->awy_db = std::make_shared<AwyDB>(paths.awy_data, executor);
+		ds->hold_db = std::make_shared<HoldDB>(paths.hold_data, executor);
+
+		{
+			std::lock_guard<std::mutex> lock(pending_mutex);
+			cancel_in_flight();
+			in_flight.push_back(ds);
+			n_pending++;
+		}
+
+		std::shared_ptr<std::promise<DbErr>> done = std::make_shared<std::promise<DbErr>>();
+		std::future<DbErr> out = done->get_future();
+
+		// Nothing blocks here: the swap is a continuation of the last load phase.
+		when_all_ready(get_phases(*ds, false), [this, ds, done]() {
+			on_loaded(ds, done);
+		});
+
+		return out;
+	}
+
+	DatasetManager::~DatasetManager()
+	{
+		std::unique_lock<std::mutex> lock(pending_mutex);
+		cancel_in_flight();
+		pending_cv.wait(lock, [this]() { return n_pending == 0; });
+	}
+
+	// Private member functions:
+
+	void DatasetManager::on_loaded(std::shared_ptr<dataset_t> ds,
+		std::shared_ptr<std::promise<DbErr>> done)
+	{
+		DbErr err = get_err(*ds);
+		if (err == DbErr::SUCCESS || err == DbErr::PARTIAL_LOAD)
+		{
+			// Airway and hold fixes of the new generation are resolved once here,
+			// so that readers don't have to look them up by their ids.
+			ds->awy_db->link_navaids(ds->navaid_db);
+			ds->hold_db->link_navaids(ds->navaid_db);
+
+			std::lock_guard<std::mutex> lock(swap_mutex);
+			dataset_ptr_t curr = std::atomic_load(&curr_dataset);
+			// Loads may finish out of order. Never replace a newer generation.
+			if (curr == nullptr || curr->generation < ds->generation)
+			{
+				std::atomic_store(&curr_dataset, dataset_ptr_t(ds));
+			}
+		}
+
+		done->set_value(err);
+		load_done(ds.get());
+	}
+
+	void DatasetManager::load_done(dataset_t* ds)
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex);
+		size_t i = 0;
+		while (i < in_flight.size())
+		{
+			std::shared_ptr<dataset_t> curr = in_flight[i].lock();
+			if (curr == nullptr || curr.get() == ds)
+			{
+				in_flight[i] = in_flight.back();
+				in_flight.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+		n_pending--;
+		pending_cv.notify_all();
+	}
+
+	/*
+		Function: cancel_in_flight
+		Description:
+		Cancels all loads that haven't finished yet. Must be called with pending_mutex held.
+	*/
+
+	void DatasetManager::cancel_in_flight()
+	{
+		for (auto& it : in_flight)
+		{
+			std::shared_ptr<dataset_t> curr = it.lock();
+			if (curr != nullptr)
+			{
+				cancel_load(*curr);
+			}
+		}
+	}
+
+	void DatasetManager::cancel_load(dataset_t& ds)
+	{
+		if (ds.arpt_db != nullptr)
+		{
+			ds.arpt_db->cancel_load();
+		}
+		if (ds.navaid_db != nullptr)
+		{
+			ds.navaid_db->cancel_load();
+		}
+		if (ds.awy_db != nullptr)
+		{
+			ds.awy_db->cancel_load();
+		}
+		if (ds.hold_db != nullptr)
+		{
+			ds.hold_db->cancel_load();
+		}
+	}
+
+	DbErr DatasetManager::get_err(dataset_t& ds)
+	{
+		DbErr out = DbErr::SUCCESS;
+		for (auto it : get_phases(ds, false))
+		{
+			DbErr err = it->wait();
+			if (err == DbErr::PARTIAL_LOAD)
+			{
+				out = err;
+			}
+			else if (err != DbErr::SUCCESS)
+			{
+				return err;
+			}
+		}
+		return out;
+	}
+
+	std::vector<LoadPhase*> DatasetManager::get_phases(dataset_t& ds, bool include_cache)
+	{
+		std::vector<LoadPhase*> out;
+		if (ds.arpt_db != nullptr)
+		{
+			out.push_back(&ds.arpt_db->get_arpt_phase());
+			out.push_back(&ds.arpt_db->get_rnw_phase());
+			if (include_cache)
+			{
+				out.push_back(&ds.arpt_db->get_cache_phase());
+			}
+		}
+		if (ds.navaid_db != nullptr)
+		{
+			out.push_back(&ds.navaid_db->get_wpt_phase());
+			out.push_back(&ds.navaid_db->get_navaid_phase());
+		}
+		if (ds.awy_db != nullptr)
+		{
+			out.push_back(&ds.awy_db->get_load_phase());
+		}
+		if (ds.hold_db != nullptr)
+		{
+			out.push_back(&ds.hold_db->get_load_phase());
+		}
+		return out;
+	}
+
+	/*
+		Function: when_all_ready
+		Description:
+		Calls func once every phase is complete. func is called either right away
+		or on the thread that completes the last phase.
+	*/
+
+	void DatasetManager::when_all_ready(std::vector<LoadPhase*> phases,
+		std::function<void()> func)
+	{
+		if (phases.empty())
+		{
+			func();
+			return;
+		}
+
+		std::shared_ptr<std::atomic<size_t>> n_left =
+			std::make_shared<std::atomic<size_t>>(phases.size());
+		for (auto it : phases)
+		{
+			it->on_ready([n_left, func](DbErr err) {
+				(void)err;
+				if (n_left->fetch_sub(1) == 1)
+				{
+					func();
+				}
+			});
+		}
+	}
+}; // namespace libnav
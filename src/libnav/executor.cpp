@@ -0,0 +1,162 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for the ThreadPool class.
+*/
+
+
+#include "libnav/executor.hpp"
+
+
+namespace libnav
+{
+	// Pool and queue of the current thread if it's a worker
+	static thread_local ThreadPool* curr_pool = nullptr;
+	static thread_local size_t curr_worker_idx = 0;
+
+
+	// ThreadPool definitions:
+	// Public member functions:
+
+	ThreadPool::ThreadPool(size_t n_threads)
+	{
+		if (n_threads == 0)
+		{
+			n_threads = size_t(std::thread::hardware_concurrency());
+			if (n_threads < N_POOL_THREADS_MIN)
+			{
+				n_threads = N_POOL_THREADS_MIN;
+			}
+		}
+
+		n_pending.store(0);
+		next_queue.store(0);
+		stop = false;
+
+		for (size_t i = 0; i < n_threads; i++)
+		{
+			queues.push_back(std::unique_ptr<worker_queue_t>(new worker_queue_t));
+		}
+		for (size_t i = 0; i < n_threads; i++)
+		{
+			workers.push_back(std::thread([](ThreadPool* pool, size_t idx) {
+				pool->worker_loop(idx);
+			}, this, i));
+		}
+	}
+
+	void ThreadPool::submit(exec_task_t task)
+	{
+		size_t idx;
+		if (curr_pool == this)
+		{
+			idx = curr_worker_idx;
+		}
+		else
+		{
+			idx = next_queue.fetch_add(1) % queues.size();
+		}
+
+		// The counter goes up first so that it never drops below zero
+		// when another worker pops the task right away.
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex);
+			n_pending++;
+		}
+		{
+			std::lock_guard<std::mutex> lock(queues[idx]->mtx);
+			queues[idx]->tasks.push_back(std::move(task));
+		}
+		wake_cv.notify_one();
+	}
+
+	size_t ThreadPool::get_n_workers()
+	{
+		return workers.size();
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex);
+			stop = true;
+		}
+		wake_cv.notify_all();
+
+		for (auto& it : workers)
+		{
+			it.join();
+		}
+	}
+
+	// Private member functions:
+
+	void ThreadPool::worker_loop(size_t idx)
+	{
+		curr_pool = this;
+		curr_worker_idx = idx;
+
+		while (true)
+		{
+			exec_task_t task;
+			if (try_pop(idx, &task))
+			{
+				task();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(wake_mutex);
+			wake_cv.wait(lock, [this]() { return n_pending.load() > 0 || stop; });
+			if (stop && n_pending.load() == 0)
+			{
+				return;
+			}
+		}
+	}
+
+	/*
+		Function: try_pop
+		Description:
+		Takes the newest task from the worker's own queue. If it's empty,
+		steals the oldest task from one of the other queues.
+	*/
+
+	bool ThreadPool::try_pop(size_t idx, exec_task_t* out)
+	{
+		size_t n_queues = queues.size();
+		for (size_t i = 0; i < n_queues; i++)
+		{
+			size_t curr = (idx + i) % n_queues;
+			std::lock_guard<std::mutex> lock(queues[curr]->mtx);
+			std::deque<exec_task_t>& tasks = queues[curr]->tasks;
+			if (tasks.size())
+			{
+				if (i == 0)
+				{
+					*out = std::move(tasks.back());
+					tasks.pop_back();
+				}
+				else
+				{
+					*out = std::move(tasks.front());
+					tasks.pop_front();
+				}
+				n_pending--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+
+	std::shared_ptr<Executor> get_default_executor()
+	{
+		static std::shared_ptr<Executor> pool = std::make_shared<ThreadPool>();
+		return pool;
+	}
+}; // namespace libnav
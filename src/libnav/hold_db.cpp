@@ -13,21 +13,25 @@ namespace libnav
 
         if(int(s_split.size()) == N_COL_AIRAC)
         {
-            data.is_parsed = true;
             data.is_airac = true;
-            data.db_version = strutils::stoi_with_strip(s_split[0]);
-            data.airac_cycle = strutils::stoi_with_strip(s_split[AIRAC_CYCLE_WORD-1]);
+            data.is_parsed = data.set_airac(s_split[0], s_split[AIRAC_CYCLE_WORD-1]);
         }
         else if(int(s_split.size()) == N_HOLD_COL_NORML)
         {
-            data.is_parsed = true;
-
             uid = s_split[0] + AUX_ID_SEP + s_split[1] + AUX_ID_SEP + s_split[2] 
                 + AUX_ID_SEP + s_split[3];
 
-            hold_data.inbd_crs_mag = strutils::stof_with_strip(s_split[4]);
-            hold_data.leg_time_min = strutils::stof_with_strip(s_split[5]);
-            hold_data.dme_leg_dist_nm = strutils::stof_with_strip(s_split[6]);
+            double inbd_crs = 0, leg_time = 0, dme_dist = 0;
+            data.is_parsed = strutils::str_to_double(s_split[4], &inbd_crs) && 
+                strutils::str_to_double(s_split[5], &leg_time) && 
+                strutils::str_to_double(s_split[6], &dme_dist) && 
+                strutils::str_to_int(s_split[8], &hold_data.min_alt_ft) && 
+                strutils::str_to_int(s_split[9], &hold_data.max_alt_ft) && 
+                strutils::str_to_int(s_split[10], &hold_data.spd_kts);
+
+            hold_data.inbd_crs_mag = float(inbd_crs);
+            hold_data.leg_time_min = float(leg_time);
+            hold_data.dme_leg_dist_nm = float(dme_dist);
             if(s_split[7][0] == 'L')
             {
                 hold_data.turn_dir = HoldTurnDir::LEFT;
@@ -36,9 +40,6 @@ namespace libnav
             {
                 hold_data.turn_dir = HoldTurnDir::RIGHT;
             }
-            hold_data.min_alt_ft = strutils::stoi_with_strip(s_split[8]);
-            hold_data.max_alt_ft = strutils::stoi_with_strip(s_split[9]);
-            hold_data.spd_kts = strutils::stoi_with_strip(s_split[10]);
         }
         else if(s_split.size() && s_split[0] == "99")
         {
@@ -50,10 +51,21 @@ namespace libnav
     // HoldDB member function definitions:
     // Public member functions:
 
-    HoldDB::HoldDB(std::string db_path)
+    HoldDB::HoldDB(std::string db_path, std::shared_ptr<Executor> exec)
     {
-        hold_load_task = std::async(std::launch::async, [](HoldDB* db, std::string db_path) -> 
-				DbErr {return db->load_holds(db_path); }, this, db_path);
+        executor = exec;
+        if(executor == nullptr)
+        {
+            executor = get_default_executor();
+        }
+
+        hold_load_task = submit_task(executor.get(), [this, db_path]() -> 
+            DbErr {
+                std::string path = db_path;
+                DbErr err = load_holds(path);
+                load_phase.set_ready(err);
+                return err;
+            });
     }
 
     DbErr HoldDB::get_err()
@@ -61,6 +73,16 @@ namespace libnav
         return hold_load_task.get();
     }
 
+    LoadPhase& HoldDB::get_load_phase()
+    {
+        return load_phase;
+    }
+
+    void HoldDB::cancel_load()
+    {
+        cancel_requested.store(true);
+    }
+
     int HoldDB::get_airac()
     {
         return airac_cycle;
@@ -90,6 +112,35 @@ namespace libnav
         return {};
     }
 
+    size_t HoldDB::link_navaids(std::shared_ptr<NavaidDB> navaid_db)
+    {
+        size_t n_unresolved = 0;
+        linked_navaid_db = navaid_db;
+        hold_wpts.clear();
+        for(auto& it: hold_db)
+        {
+            const waypoint_entry_t* wpt = navaid_db->find_wpt_by_hold_str(it.first);
+            hold_wpts[it.first] = wpt;
+            n_unresolved += size_t(wpt == nullptr);
+        }
+        return n_unresolved;
+    }
+
+    bool HoldDB::is_linked()
+    {
+        return linked_navaid_db != nullptr;
+    }
+
+    const waypoint_entry_t* HoldDB::get_hold_wpt(const std::string& hold_id)
+    {
+        auto it = hold_wpts.find(hold_id);
+        if(it == hold_wpts.end())
+        {
+            return nullptr;
+        }
+        return it->second;
+    }
+
     DbErr HoldDB::load_holds(std::string& db_path)
     {
         DbErr out_code = DbErr::SUCCESS;
@@ -101,6 +152,11 @@ namespace libnav
             int i = 1;
 			while (getline(file, line))
 			{
+                if(cancel_requested.load(std::memory_order_relaxed))
+                {
+                    return DbErr::CANCELLED;
+                }
+
                 hold_line_t hold_line(line);
                 if(!hold_line.data.is_parsed && i > N_EARTH_LINES_IGNORE)
                 {
@@ -133,4 +189,14 @@ namespace libnav
         }
         return out_code;
     }
+
+    HoldDB::~HoldDB()
+    {
+        // The load task references this object, so it must finish first.
+        cancel_load();
+        if(hold_load_task.valid())
+        {
+            hold_load_task.wait();
+        }
+    }
 };
@@ -0,0 +1,111 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for AirportCache class.
+	AirportCache keeps recently used airports in memory and hands out read-only
+	references to them, so flight plans don't have to copy procedure data.
+*/
+
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <new>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "cifp_parser.hpp"
+#include "executor.hpp"
+
+
+namespace libnav
+{
+	constexpr size_t ARPT_CACHE_DEF_BUDGET = 64 * 1024 * 1024;  // In bytes
+
+
+	typedef std::shared_ptr<const Airport> airport_cptr_t;
+
+
+	class AirportCache
+	{
+		struct cache_entry_t
+		{
+			std::string icao;
+			airport_cptr_t apt;
+			size_t mem_usage;
+		};
+
+		typedef std::list<cache_entry_t> lru_list_t;
+
+	public:
+		/*
+			Function: AirportCache
+			Description:
+			@param budget: number of bytes the cached airports may use. The most recently
+			used airport is always kept, even if it alone exceeds the budget.
+			@param exec: executor to load airports on. nullptr means the default pool.
+			@param archive: optional CIFP archive to load airports from.
+			The rest of the parameters are passed on to the Airport constructor.
+		*/
+
+		AirportCache(std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db,
+			std::string cifp_path, size_t budget=ARPT_CACHE_DEF_BUDGET,
+			std::string postfix=".dat", bool use_pr=false, appr_pref_db_t pr_db=APPR_PREF,
+			std::shared_ptr<Executor> exec=nullptr,
+			std::shared_ptr<const CifpArchive> archive=nullptr);
+
+		/*
+			Function: get
+			Description:
+			Returns an airport from the cache. Loads it on a miss. Concurrent misses for
+			the same airport share one load. An evicted airport stays valid for as long
+			as someone holds a pointer to it. Blocks on a miss, so it must not be called
+			from a task running on the cache's executor.
+			@param icao: ICAO code of the airport
+			@return pointer to the airport. Check err_code of the airport before using it.
+			nullptr if the airport couldn't be allocated.
+		*/
+
+		airport_cptr_t get(std::string icao);
+
+		void set_mem_budget(size_t budget);
+
+		void clear();
+
+		size_t get_mem_usage();
+
+		size_t get_n_airports();
+
+		size_t get_n_hits();
+
+		size_t get_n_misses();
+
+	private:
+		std::shared_ptr<ArptDB> arpt_db_ptr;
+		std::shared_ptr<NavaidDB> navaid_db_ptr;
+		std::shared_ptr<Executor> executor;
+		std::shared_ptr<const CifpArchive> cifp_archive;
+		std::string cifp_dir_path;
+		std::string cifp_postfix;
+		bool use_appch_prefix;
+		appr_pref_db_t appch_prefix_db;
+
+		std::mutex cache_mutex;
+		lru_list_t lru;  // Most recently used airport is at the front
+		std::unordered_map<std::string, lru_list_t::iterator> entries;
+		size_t mem_budget;
+		size_t mem_usage;
+		size_t n_hits;
+		size_t n_misses;
+
+
+		// Must be called with cache_mutex held
+		void evict();
+	};
+}; // namespace libnav
@@ -1,195 +1,301 @@
-/*
-	This project is licensed under
-	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
-
-	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
-
-	Author: discord/bruh4096#4512
-
-	This file contains declarations of member functions for ArptDB class. ArptDB is an interface which allows
-	to create a custom airport data base using x-plane's apt.dat. The class also allows you to access the data
-	base and perform some searches on it.
-*/
-
-
-#pragma once
-
-#include <future>
-#include <fstream>
-#include <unordered_map>
-#include <vector>
-#include <iterator>
-#include <string>
-#include <sstream>
-#include <algorithm>
-#include <ctype.h>
-#include "str_utils.hpp"
-#include "geo_utils.hpp"
-#include "common.hpp"
-
-
-namespace libnav
-{
-	constexpr double DB_VERSION = 1.7; // Change this if you want to rebuild runway and airport data bases
-	constexpr int N_ARPT_LINES_IGNORE = 3;
-	// N_HEADER_STR_WORDS is the number of words in a string declaring the data base
-	// version.
-	constexpr int N_HEADER_STR_WORDS = 4;
-	// Number of items to ignore at the beginning of the land runway declaration.
-	constexpr int N_RNW_ITEMS_IGNORE_BEGINNING = 8;
-	constexpr int N_RNW_ITEMS_IGNORE_END = 5;
-	// Number of indices after the decimal in the string representation of a double number
-	constexpr int N_DOUBLE_OUT_PRECISION = 9;
-	// If the longest runway of the airport is less than this, the airport will not be included in the database
-	constexpr double MIN_RWY_LENGTH_M = 1000;
-	constexpr char DEFAULT_COMMENT_CHAR = '#';
-
-
-	enum class XPLMArptRowCode 
-	{
-		LAND_ARPT = 1,
-		MISC_DATA = 1302,
-		LAND_RUNWAY = 100,
-		DB_EOF = 99
-	};
-
-
-	struct runway_entry_t
-	{
-		geo::point start, end;
-		int displ_threshold_m;
-		double impl_length_m = -1;
-
-		double get_impl_length_m()
-		{
-			if (impl_length_m <= 0)
-			{
-				impl_length_m = start.get_gc_dist_nm(end) * geo::NM_TO_M;
-			}
-			return impl_length_m;
-		}
-	};
-
-	typedef std::unordered_map<std::string, runway_entry_t> runway_data;
-
-	struct runway_t
-	{
-		std::string id;
-		runway_entry_t data;
-	};
-
-	struct airport_data_t
-	{
-		geo::point pos;
-		uint32_t elevation_ft, transition_alt_ft, transition_level;
-	};
-
-	struct airport_entry_t
-	{
-		std::unordered_map<std::string, runway_entry_t> runways;
-		airport_data_t data;
-	};
-
-	struct airport_t
-	{
-		std::string icao;
-		airport_data_t data;
-	};
-
-	struct rnw_data_t
-	{
-		std::string icao; //Airport icao
-		std::vector<runway_t> runways;
-	};
-
-
-	typedef std::unordered_map<std::string, airport_data_t> airport_db_t;
-	typedef std::unordered_map<std::string, 
-		std::unordered_map<std::string, runway_entry_t>> rnw_db_t;
-
-
-	class ArptDB
-	{
-		typedef std::pair<std::string, airport_data_t> str_arpt_data_t;
-		typedef std::pair<std::string, std::unordered_map<std::string, runway_entry_t>> 
-			str_rnw_t;
-
-	public:
-		DbErr err_code;
-
-		ArptDB(std::string sim_arpt_path, std::string custom_arpt_path,
-			std::string custom_rnw_path, double min_rwy_l_m = MIN_RWY_LENGTH_M);
-
-		DbErr get_err();
-
-		const airport_db_t& get_arpt_db();
-
-		const rnw_db_t& get_rnw_db();
-
-		//These functions need to be public because they're used in 
-		//other threads when ArptDB object is constructed.
-
-		int load_from_sim_db();
-
-		void write_to_arpt_db();
-
-		void write_to_rnw_db();
-
-		void load_from_custom_arpt(); // Load data from custom airport database
-
-		void load_from_custom_rnw(); // Load data from custom runway database
-
-		// Normal user interface functions:
-
-		bool is_airport(std::string icao_code);
-
-		bool get_airport_data(std::string icao_code, airport_data_t* out);
-
-		int get_apt_rwys(std::string icao_code, runway_data* out);
-
-		int get_rnw_data(std::string apt_icao, std::string rnw_id, runway_entry_t* out);
-
-	private:
-		int db_version;  // May be used later
-		double min_rwy_length_m;
-
-		std::string custom_arpt_db_sign = "ARPTDB";
-		std::string custom_rnw_db_sign = "RNWDB";
-		bool apt_db_created = false;
-		bool rnw_db_created = false;
-
-		// Data for creating a custom airport database
-
-		std::atomic<bool> write_arpt_db{ false };
-
-		std::vector<airport_t> arpt_queue;
-		std::vector<rnw_data_t> rnw_queue;
-
-		std::mutex arpt_queue_mutex;
-		std::mutex rnw_queue_mutex;
-
-		std::mutex arpt_db_mutex;
-		std::mutex rnw_db_mutex;
-
-		std::string sim_arpt_db_path;
-		std::string custom_arpt_db_path;
-		std::string custom_rnw_db_path;
-
-		std::future<int> sim_db_loaded;
-		std::future<void> arpt_db_task;
-		std::future<void> rnw_db_task;
-
-		airport_db_t arpt_db;
-		rnw_db_t rnw_db;
-
-		static bool does_db_exist(std::string path, std::string sign);
-
-		static int get_db_version(std::string& line);
-
-		double parse_runway(std::string line, std::vector<runway_t>* rnw); // Returns runway length in meters
-
-		void add_to_arpt_queue(airport_t arpt);
-
-		void add_to_rnw_queue(rnw_data_t rnw);
-	};
-} // namespace libnav
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for ArptDB class. ArptDB is an interface which allows
+	to create a custom airport data base using x-plane's apt.dat. The class also allows you to access the data
+	base and perform some searches on it.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include <iterator>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+#include <ctype.h>
+#include "str_utils.hpp"
+#include "geo_utils.hpp"
+#include "common.hpp"
+#include "executor.hpp"
+#include "load_phase.hpp"
+
+
+namespace libnav
+{
+	constexpr double DB_VERSION = 1.7; // Change this if you want to rebuild runway and airport data bases
+	constexpr int N_ARPT_LINES_IGNORE = 3;
+	// N_HEADER_STR_WORDS is the number of words in a string declaring the data base
+	// version.
+	constexpr int N_HEADER_STR_WORDS = 4;
+	// Number of items to ignore at the beginning of the land runway declaration.
+	constexpr int N_RNW_ITEMS_IGNORE_BEGINNING = 8;
+	constexpr int N_RNW_ITEMS_IGNORE_END = 5;
+	// Number of indices after the decimal in the string representation of a double number
+	constexpr int N_DOUBLE_OUT_PRECISION = 9;
+	// If the longest runway of the airport is less than this, the airport will not be included in the database
+	constexpr double MIN_RWY_LENGTH_M = 1000;
+	constexpr char DEFAULT_COMMENT_CHAR = '#';
+
+
+	enum class XPLMArptRowCode 
+	{
+		LAND_ARPT = 1,
+		MISC_DATA = 1302,
+		LAND_RUNWAY = 100,
+		DB_EOF = 99
+	};
+
+
+	struct runway_entry_t
+	{
+		geo::stored_point start, end;
+		int displ_threshold_m;
+		double impl_length_m = -1;
+
+		double get_impl_length_m()
+		{
+			if (impl_length_m <= 0)
+			{
+				impl_length_m = geo::point(start).get_gc_dist_nm(end) * geo::NM_TO_M;
+			}
+			return impl_length_m;
+		}
+	};
+
+	typedef std::unordered_map<std::string, runway_entry_t> runway_data;
+
+	struct runway_t
+	{
+		std::string id;
+		runway_entry_t data;
+	};
+
+	struct airport_data_t
+	{
+		geo::stored_point pos;
+		uint32_t elevation_ft, transition_alt_ft, transition_level;
+	};
+
+	struct airport_entry_t
+	{
+		std::unordered_map<std::string, runway_entry_t> runways;
+		airport_data_t data;
+	};
+
+	struct airport_t
+	{
+		std::string icao;
+		airport_data_t data;
+	};
+
+	struct rnw_data_t
+	{
+		std::string icao; //Airport icao
+		std::vector<runway_t> runways;
+	};
+
+
+	typedef std::unordered_map<std::string, airport_data_t> airport_db_t;
+	typedef std::unordered_map<std::string, 
+		std::unordered_map<std::string, runway_entry_t>> rnw_db_t;
+
+	struct arpt_db_snapshot_t
+	// Read-only data of ArptDB. Published once all loaders are done.
+	{
+		airport_db_t arpt_db;
+		rnw_db_t rnw_db;
+	};
+
+	typedef std::shared_lock<std::shared_timed_mutex> arpt_read_lock_t;
+
+
+	class ArptDB
+	{
+		typedef std::pair<std::string, airport_data_t> str_arpt_data_t;
+		typedef std::pair<std::string, std::unordered_map<std::string, runway_entry_t>> 
+			str_rnw_t;
+
+	public:
+		DbErr err_code;
+
+		/*
+			Function: ArptDB
+			Description:
+			Starts loading the airport data base. If the custom data base files don't exist,
+			apt.dat is parsed and the custom files are written once parsing is done.
+			Param:
+			exec: executor to run load tasks on. nullptr means the default pool.
+		*/
+
+		ArptDB(std::string sim_arpt_path, std::string custom_arpt_path,
+			std::string custom_rnw_path, double min_rwy_l_m = MIN_RWY_LENGTH_M, 
+			std::shared_ptr<Executor> exec = nullptr);
+
+		// Waits for all phases including the custom data base files.
+		DbErr get_err();
+
+		/*
+			Function: get_arpt_phase
+			Description:
+			Airports can be queried once this phase is ready. Runways may still be loading.
+		*/
+
+		LoadPhase& get_arpt_phase();
+
+		/*
+			Function: get_rnw_phase
+			Description:
+			Runways can be queried once this phase is ready.
+		*/
+
+		LoadPhase& get_rnw_phase();
+
+		/*
+			Function: get_cache_phase
+			Description:
+			Ready once the custom airport and runway files have been written.
+			The data base is fully usable before that.
+		*/
+
+		LoadPhase& get_cache_phase();
+
+		const airport_db_t& get_arpt_db();
+
+		const rnw_db_t& get_rnw_db();
+
+		//These functions need to be public because they're used in 
+		//other threads when ArptDB object is constructed.
+
+		int load_from_sim_db();
+
+		bool write_to_arpt_db();
+
+		bool write_to_rnw_db();
+
+		DbErr load_from_custom_arpt(); // Load data from custom airport database
+
+		DbErr load_from_custom_rnw(); // Load data from custom runway database
+
+		/*
+			Function: cancel_load
+			Description:
+			Asks the loaders and writers to stop. They return within one line of input and
+			their phases become ready with DbErr::CANCELLED. Custom files that have been
+			only partially written are removed.
+		*/
+
+		void cancel_load();
+
+		~ArptDB();
+
+		// Normal user interface functions:
+
+		bool is_airport(std::string icao_code);
+
+		bool get_airport_data(std::string icao_code, airport_data_t* out);
+
+		int get_apt_rwys(std::string icao_code, runway_data* out);
+
+		int get_rnw_data(std::string apt_icao, std::string rnw_id, runway_entry_t* out);
+
+		size_t get_apts_in_range(geo::point pos, double dist_nm, std::vector<airport_t>* out);
+
+	private:
+		int db_version;  // May be used later
+		double min_rwy_length_m;
+
+		std::string custom_arpt_db_sign = "ARPTDB";
+		std::string custom_rnw_db_sign = "RNWDB";
+		bool apt_db_created = false;
+		bool rnw_db_created = false;
+
+		// Data for creating a custom airport database.
+		// The queues are written out once load_from_sim_db is done.
+
+		std::vector<airport_t> arpt_queue;
+		std::vector<rnw_data_t> rnw_queue;
+
+		std::mutex arpt_queue_mutex;
+		std::mutex rnw_queue_mutex;
+
+		// Readers only take these while the data base is being loaded.
+		std::shared_timed_mutex arpt_db_mutex;
+		std::shared_timed_mutex rnw_db_mutex;
+
+		std::atomic<int> n_loads_pending;
+		std::unique_ptr<arpt_db_snapshot_t> snapshot_data;
+		std::atomic<const arpt_db_snapshot_t*> snapshot;
+
+		std::string sim_arpt_db_path;
+		std::string custom_arpt_db_path;
+		std::string custom_rnw_db_path;
+
+		std::shared_ptr<Executor> executor;
+
+		std::future<int> sim_db_loaded;
+		std::future<void> arpt_db_task;
+		std::future<void> rnw_db_task;
+
+		// Writers are submitted as continuations of load_from_sim_db.
+		std::promise<void> arpt_write_done;
+		std::promise<void> rnw_write_done;
+		std::atomic<int> n_writes_pending;
+		std::atomic<bool> write_cancelled;
+
+		std::atomic<bool> cancel_requested;
+
+		LoadPhase arpt_phase;
+		LoadPhase rnw_phase;
+		LoadPhase cache_phase;
+
+		airport_db_t arpt_db;
+		rnw_db_t rnw_db;
+
+		static bool does_db_exist(std::string path, std::string sign);
+
+		static int get_db_version(std::string& line);
+
+		double parse_runway(std::string line, std::vector<runway_t>* rnw); // Returns runway length in meters
+
+		void add_to_arpt_queue(airport_t arpt);
+
+		void add_to_rnw_queue(rnw_data_t rnw);
+
+		void submit_writers();
+
+		void on_write_done(bool is_written);
+
+		void add_to_arpt_db(std::string& icao, airport_data_t& data);
+
+		void add_to_rnw_db(std::string& icao, runway_data& runways);
+
+		void on_load_done();
+
+		void publish_snapshot();
+
+		/*
+			The following functions return the published data if there is any.
+			Otherwise they take a shared lock of the data that is still being 
+			loaded and return a reference to it.
+		*/
+
+		const airport_db_t& get_arpt_view(arpt_read_lock_t& lock);
+
+		const rnw_db_t& get_rnw_view(arpt_read_lock_t& lock);
+	};
+} // namespace libnav
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -22,6 +24,8 @@
 #include <vector>
 #include "str_utils.hpp"
 #include "navaid_db.hpp"
+#include "executor.hpp"
+#include "load_phase.hpp"
 
 
 namespace libnav
@@ -31,6 +35,7 @@ namespace libnav
     constexpr char AWY_RESTR_FWD = 'F';
     constexpr char AWY_RESTR_BWD = 'B';
     constexpr char AWY_RESTR_NONE = 'N';
+    constexpr uint32_t AWY_IDX_NONE = UINT32_MAX;
 
 
     struct alt_restr_t
@@ -38,6 +43,43 @@ namespace libnav
         uint32_t lower, upper;
     };
 
+    struct awy_edge_t
+    {
+        uint32_t to;  // Index of the fix that the segment leads to
+        uint32_t awy;  // Index of the airway
+        alt_restr_t alt_restr;
+    };
+
+    struct awy_hop_t
+    {
+        uint32_t fix;
+        // Restriction of the segment that leaves the fix. The last fix of a path
+        // gets the restriction of the segment that leads to it.
+        alt_restr_t alt_restr;
+    };
+
+    /*
+        Struct: awy_scratch_t
+        Description:
+        Reusable state for the index based traversal functions of AwyDB. Keep one
+        per thread and pass it to every call. Once it has grown to the size of the
+        data base, traversals don't allocate. Fixes are marked as visited with the
+        number of the search, so the arrays don't need to be cleared between calls.
+    */
+
+    struct awy_scratch_t
+    {
+        std::vector<uint32_t> visit_gen;
+        std::vector<uint32_t> prev;  // Previous fix
+        std::vector<uint32_t> prev_edge;  // Index of the segment from the previous fix
+        std::vector<uint32_t> queue;
+        uint32_t gen = 0;
+
+
+        // Prepares the scratch for a new search over n_fixes fixes
+        void start(size_t n_fixes);
+    };
+
     struct awy_entry_t
     {
         std::string xp_type, reg_code;  // Region code of navaid/fix
@@ -78,32 +120,169 @@ namespace libnav
 
     struct awy_to_awy_data_t;
 
+    class AwyDB;
+
 
     typedef std::unordered_map<std::string, std::unordered_map<std::string, alt_restr_t>> graph_t;
     typedef std::unordered_map<std::string, graph_t> awy_db_t;
+    // Maps other airway to the fixes it shares with the airway
+    typedef std::unordered_map<std::string, std::vector<std::string>> awy_isect_t;
+    typedef std::unordered_map<std::string, awy_isect_t> awy_isect_db_t;
     typedef bool (*awy_path_func_t)(std::string&, void*);
+    typedef bool (*awy_idx_path_func_t)(uint32_t, void*);
 
 
     bool awy_wpt_to_wpt_func(std::string& curr, void* ref);
 
     bool awy_awy_to_awy_func(std::string& curr, void* ref);
+
+    // ref must point to a std::vector<std::string> of target fixes
+    bool awy_wpt_to_set_func(std::string& curr, void* ref);
+
+    // ref must point to the uint32_t index of the target fix
+    bool awy_idx_wpt_to_wpt_func(uint32_t curr, void* ref);
+
+    // ref must point to awy_idx_to_awy_data_t
+    bool awy_idx_awy_to_awy_func(uint32_t curr, void* ref);
     
 
     class AwyDB
     {
     public:
 
-        AwyDB(std::string awy_path);
+        /*
+            Function: AwyDB
+            Description:
+            Starts loading the airway data base.
+            @param awy_path: path to earth_awy.dat
+            @param exec: executor to run the load task on. nullptr means the default pool.
+        */
+
+        AwyDB(std::string awy_path, std::shared_ptr<Executor> exec=nullptr);
 
         DbErr get_err();
 
+        /*
+            Function: get_load_phase
+            Description:
+            Unlike get_err, the phase can be polled and waited on many times
+            and allows to register completion callbacks.
+            @return reference to the phase object
+        */
+
+        LoadPhase& get_load_phase();
+
+        /*
+            Function: cancel_load
+            Description:
+            Asks the loader to stop. It returns DbErr::CANCELLED within one line of input.
+        */
+
+        void cancel_load();
+
         int get_airac();
 
         int get_db_version();
 
         const awy_db_t& get_db();
 
-        bool is_in_awy(std::string awy, std::string point);
+        bool is_in_awy(const std::string& awy, const std::string& point);
+
+        /*
+            Function: get_isect
+            Description:
+            Returns the airways that cross awy along with the fixes they share with it.
+            The index is built when the data base is loaded.
+            @param awy: airway name
+            @return pointer to the intersection table of awy. nullptr if awy
+            doesn't cross any other airway.
+        */
+
+        const awy_isect_t* get_isect(const std::string& awy);
+
+        /*
+            Function: get_shared_fixes
+            Description:
+            @param awy: airway name
+            @param other: name of the other airway
+            @return pointer to the airway ids of the fixes that awy and other share.
+            nullptr if they don't intersect.
+        */
+
+        const std::vector<std::string>* get_shared_fixes(const std::string& awy, 
+            const std::string& other);
+
+        /*
+            Function: get_fix_idx
+            Description:
+            Fixes and airways are numbered when the data base is loaded. The indices
+            follow the order of the airway ids/names, so they don't change as long
+            as the data doesn't.
+            @param uid: airway id of the fix
+            @return index of the fix. AWY_IDX_NONE if the fix isn't on any airway.
+        */
+
+        uint32_t get_fix_idx(const std::string& uid);
+
+        size_t get_n_fixes();
+
+        const std::string& get_fix_uid(uint32_t idx);
+
+        // Returns AWY_IDX_NONE if there is no such airway
+        uint32_t get_awy_idx(const std::string& awy);
+
+        size_t get_n_awys();
+
+        const std::string& get_awy_name(uint32_t idx);
+
+        /*
+            Function: get_fix_awys
+            Description:
+            @param idx: index of the fix
+            @return indices of the airways that go through the fix in ascending order.
+            Empty if idx is out of range.
+        */
+
+        span_t<uint32_t> get_fix_awys(uint32_t idx);
+
+        span_t<uint32_t> get_fix_awys(const std::string& uid);
+
+        /*
+            Function: get_fix_edges
+            Description:
+            @param idx: index of the fix
+            @return segments that can be flown from the fix, sorted by airway index
+            and then by the index of the next fix. Empty if idx is out of range.
+        */
+
+        span_t<awy_edge_t> get_fix_edges(uint32_t idx);
+
+        span_t<awy_edge_t> get_fix_edges(const std::string& uid);
+
+        /*
+            Function: link_navaids
+            Description:
+            Resolves every fix of the data base to its navaid data base entry, so that
+            get_fix_wpt doesn't need to do any string work. Both data bases must be
+            fully loaded. Must be called before the data base is shared with other threads.
+            @param navaid_db: pointer to the navaid data base. It's kept alive for
+            as long as this data base is.
+            @return number of fixes that weren't found in the navaid data base
+        */
+
+        size_t link_navaids(std::shared_ptr<NavaidDB> navaid_db);
+
+        bool is_linked();
+
+        /*
+            Function: get_fix_wpt
+            Description:
+            @param idx: index of the fix
+            @return pointer to the navaid data base entry of the fix. nullptr if the
+            fix wasn't found there or link_navaids hasn't been called.
+        */
+
+        const waypoint_entry_t* get_fix_wpt(uint32_t idx);
 
         /*
             Fucntion: get_ww_path
@@ -150,6 +329,53 @@ namespace libnav
         size_t get_path(std::string awy, std::string start, 
             std::vector<awy_point_t>* out, awy_path_func_t path_func, void* ref);
 
+        /*
+            Function: is_in_awy
+            Description:
+            Index based version of is_in_awy. Uses a binary search over the airways
+            of the fix.
+        */
+
+        bool is_in_awy(uint32_t awy, uint32_t fix);
+
+        /*
+            Function: get_ww_path
+            Description:
+            Index based version of get_ww_path. See get_path below.
+        */
+
+        size_t get_ww_path(uint32_t awy, uint32_t start, uint32_t end, 
+            awy_scratch_t* scratch, std::vector<awy_hop_t>* out);
+
+        /*
+            Function: get_aa_path
+            Description:
+            Index based version of get_aa_path. See get_path below.
+        */
+
+        size_t get_aa_path(uint32_t awy, uint32_t start, uint32_t next_awy, 
+            awy_scratch_t* scratch, std::vector<awy_hop_t>* out);
+
+        /*
+            Function: get_path
+            Description:
+            Traverses the airway using fix and airway indices. Doesn't allocate
+            once the scratch and out have grown large enough. The path is written
+            to out in forward order. Can be called from multiple threads at once 
+            as long as each of them uses its own scratch.
+            @param awy: index of the airway to be traversed
+            @param start: index of the start fix
+            @param scratch: pointer to reusable search state
+            @param out: pointer to output vector
+            @param path_func: termination function. Must return true when traversing
+            has to be stopped
+            @param ref: pointer to miscellaneous data passed to path_func
+            @return size of out. 0 if path_func never returned true.
+        */
+
+        size_t get_path(uint32_t awy, uint32_t start, awy_scratch_t* scratch, 
+            std::vector<awy_hop_t>* out, awy_idx_path_func_t path_func, void* ref);
+
         // You aren't supposed to call this function.
         // It's public to allow for the concurrent loading
         DbErr load_airways(std::string awy_path);
@@ -157,11 +383,34 @@ namespace libnav
         ~AwyDB();
 
     private:
-        int airac_cycle, db_version;
+        int airac_cycle = 0, db_version = 0;
         awy_db_t awy_db;
+        awy_isect_db_t isect_db;
+
+        std::vector<std::string> fix_uids;
+        std::vector<std::string> awy_names;
+        std::unordered_map<std::string, uint32_t> fix_ids;
+        std::unordered_map<std::string, uint32_t> awy_ids;
+        // Airways at fix i are fix_awys[fix_awy_start[i]] .. fix_awys[fix_awy_start[i+1]-1]
+        std::vector<uint32_t> fix_awy_start;
+        std::vector<uint32_t> fix_awys;
+        // Same layout as above
+        std::vector<uint32_t> fix_edge_start;
+        std::vector<awy_edge_t> fix_edges;
+
+        std::shared_ptr<NavaidDB> linked_navaid_db;
+        std::vector<const waypoint_entry_t*> fix_wpts;  // Indexed by fix
+        std::shared_ptr<Executor> executor;
         std::future<DbErr> db_loaded;
+        LoadPhase load_phase;
+        std::atomic<bool> cancel_requested{false};
 
         void add_to_awy_db(awy_point_t p1, awy_point_t p2, std::string awy_nm, char restr);
+
+        void build_fix_index();
+
+        // Must be called after build_fix_index
+        void build_isect_db();
     };
 
 
@@ -170,4 +419,10 @@ namespace libnav
         std::string tgt_awy;
         AwyDB *db_ptr;
     };
+
+    struct awy_idx_to_awy_data_t
+    {
+        uint32_t tgt_awy;
+        AwyDB *db_ptr;
+    };
 }; // namespace libnav
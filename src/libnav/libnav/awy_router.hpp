@@ -0,0 +1,129 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for AwyRouter class.
+	AwyRouter finds the shortest airway route between 2 fixes over the whole
+	airway network. Airways can be changed at the fixes they share.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "awy_db.hpp"
+#include "navaid_db.hpp"
+
+
+namespace libnav
+{
+	// Default cost of changing the airway at a fix. Keeps the router from
+	// hopping between parallel airways to save a fraction of a mile.
+	constexpr double AWY_ROUTE_CHANGE_NM = 20;
+
+
+	struct awy_route_opts_t
+	{
+		uint32_t fl = 0;  // Cruise flight level. 0 means altitude restrictions are ignored
+		double awy_change_nm = AWY_ROUTE_CHANGE_NM;
+	};
+
+	struct awy_route_leg_t
+	{
+		std::string awy;  // Airway that leads to the fix. Empty for the first fix
+		awy_point_t point;  // id is the airway id of the fix
+		double dist_nm;  // Length of the leg
+	};
+
+
+	class AwyRouter
+	{
+		struct edge_t
+		{
+			uint32_t to;
+			uint32_t awy;
+			alt_restr_t alt_restr;
+			double dist_nm;
+		};
+
+		struct state_t
+		{
+			double f;  // Cost so far + heuristic
+			uint32_t edge;
+		};
+
+		struct StateCompare
+		{
+			bool operator()(const state_t& s1, const state_t& s2)
+			{
+				return s1.f > s2.f;
+			}
+		};
+
+	public:
+		/*
+			Function: AwyRouter
+			Description:
+			Builds a compact copy of the airway network. Nodes are positioned using
+			the links made by AwyDB::link_navaids or, if there are none, by looking the
+			fixes up in the navaid data base. Fixes that can't be found there are left
+			out along with their segments. Both data bases must be fully loaded, i.e.
+			get_err of AwyDB and get_wpt_err/get_navaid_err of NavaidDB must have returned.
+			@param awy_db: pointer to the airway data base
+			@param navaid_db: pointer to the navaid data base
+		*/
+
+		AwyRouter(std::shared_ptr<AwyDB> awy_db, std::shared_ptr<NavaidDB> navaid_db);
+
+		size_t get_n_nodes() const;
+
+		size_t get_n_edges() const;
+
+		// Number of airway fixes that weren't found in the navaid data base
+		size_t get_n_unresolved() const;
+
+		const std::string& get_node_uid(size_t idx) const;
+
+		bool has_fix(const std::string& uid) const;
+
+		/*
+			Function: get_route
+			Description:
+			Finds the shortest airway route from start to end using A* with great
+			circle distance as the heuristic. Segments are only flown in the directions
+			allowed by the data base. This function doesn't modify the router, so it
+			can be called from multiple threads at once.
+			@param start: airway id of the start fix
+			@param end: airway id of the end fix
+			@param out: pointer to output vector. The first leg is the start fix.
+			@param opts: routing options
+			@return size of out. 0 if there is no route.
+		*/
+
+		size_t get_route(const std::string& start, const std::string& end,
+			std::vector<awy_route_leg_t>* out, awy_route_opts_t opts={}) const;
+
+	private:
+		// Nodes have the same indices as the fixes of AwyDB
+		std::shared_ptr<AwyDB> awy_db_ptr;
+		std::vector<geo::point> node_pos;
+		std::vector<bool> is_resolved;
+
+		// Outgoing edges of node i are edges[edge_start[i]] .. edges[edge_start[i+1]-1]
+		std::vector<uint32_t> edge_start;
+		std::vector<edge_t> edges;
+
+		size_t n_unresolved;
+
+
+		uint32_t get_node(const std::string& uid) const;
+
+		static bool is_allowed(const edge_t& e, const awy_route_opts_t& opts);
+	};
+}; // namespace libnav
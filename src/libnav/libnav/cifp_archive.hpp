@@ -0,0 +1,143 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for CifpArchive class.
+	A CIFP archive packs the CIFP files of all airports into one binary file with
+	an offset table, so that opening an airport doesn't need its own file.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "arpt_db.hpp"
+#include "common.hpp"
+
+
+namespace libnav
+{
+	const std::string CIFP_ARCHIVE_SIGN = "LIBNAVCIFP";
+	constexpr uint32_t CIFP_ARCHIVE_VERSION = 1;
+	constexpr uint32_t CIFP_ARCHIVE_BOM = 0x01020304;  // Detects foreign byte order
+	constexpr size_t CIFP_ARCHIVE_ICAO_SZ = 8;
+
+
+	/*
+		Layout, all integers in host byte order:
+		header: signature, version, byte order mark, AIRAC cycle, number of airports
+		table: per airport ICAO code(zero padded), offset and size of its records
+		records: contents of the CIFP files of all airports, back to back
+	*/
+
+	class CifpArchive
+	{
+		struct apt_span_t
+		{
+			uint64_t offset;
+			uint64_t size;
+		};
+
+	public:
+		/*
+			Function: CifpArchive
+			Description:
+			Reads an archive into memory.
+			@param path: path to the archive file
+		*/
+
+		CifpArchive(std::string path);
+
+		/*
+			Function: get_err
+			@return DbErr::SUCCESS, DbErr::FILE_NOT_FOUND or DbErr::DATA_BASE_ERROR if
+			the file isn't an archive of this version and byte order.
+		*/
+
+		DbErr get_err() const;
+
+		int get_airac() const;
+
+		size_t get_n_airports() const;
+
+		/*
+			Function: is_stale
+			Description:
+			Checks if the archive was compiled for a different AIRAC cycle. Procedures
+			from a stale archive don't match the navigation data bases.
+			@param airac_cycle: cycle of the data bases in use
+		*/
+
+		bool is_stale(int airac_cycle) const;
+
+		/*
+			Function: get_airport
+			Description:
+			Finds the CIFP records of an airport.
+			@param icao: ICAO code of the airport
+			@param out: set to the first byte of the records. The pointer stays valid
+			for the lifetime of the archive.
+			@param out_sz: set to the number of bytes
+			@return true if the archive contains the airport.
+		*/
+
+		bool get_airport(const std::string& icao, const char** out, size_t* out_sz) const;
+
+		/*
+			Function: compile
+			Description:
+			Packs the CIFP files of all airports in the airport data base into an archive.
+			The archive is written to a temporary file first, so readers never see a
+			partially written one.
+			@param out_path: path of the archive file
+			@param arpt_db: airport data base. Defines the airports to look for.
+			@param cifp_path: path to the CIFP directory
+			@param postfix: file extension of the CIFP files
+			@param airac_cycle: cycle to stamp the archive with
+			@param n_written: optional. Set to the number of airports written.
+			@return DbErr::SUCCESS or DbErr::FILE_NOT_FOUND if the archive couldn't be written.
+		*/
+
+		static DbErr compile(std::string out_path, std::shared_ptr<ArptDB> arpt_db,
+			std::string cifp_path, std::string postfix, int airac_cycle,
+			size_t* n_written=nullptr);
+
+	private:
+		DbErr err_code;
+		int airac;
+		std::vector<char> data;
+		std::unordered_map<std::string, apt_span_t> airports;
+
+
+		DbErr read_archive(std::string& path);
+
+		template<class T>
+		static bool read_val(const std::vector<char>& buf, size_t* pos, T* out)
+		{
+			if (buf.size() < *pos + sizeof(T))
+				return false;
+			std::memcpy(out, buf.data() + *pos, sizeof(T));
+			*pos += sizeof(T);
+			return true;
+		}
+
+		template<class T>
+		static void write_val(std::ofstream& out, T val)
+		{
+			out.write(reinterpret_cast<const char*>(&val), std::streamsize(sizeof(T)));
+		}
+	};
+}; // namespace libnav
@@ -22,7 +22,12 @@
 #include <unordered_map>
 #include <set>
 #include <mutex>
+#include <memory>
+#include <future>
+#include <functional>
 #include "arpt_db.hpp"
+#include "cifp_archive.hpp"
+#include "executor.hpp"
 #include "navaid_db.hpp"
 #include "common.hpp"
 #include "str_utils.hpp"
@@ -135,15 +140,15 @@ namespace libnav
 
     TurnDir char2dir(char c);  // Ref: arinc section 5.20
 
-    float str2rnp(std::string s);  // Ref: arinc section 5.211
+    float str2rnp(const std::string& s);  // Ref: arinc section 5.211
 
-    float str2outbd_crs(std::string s, bool* is_true);  // Ref: arinc 5.26
+    float str2outbd_crs(const std::string& s, bool* is_true);  // Ref: arinc 5.26
 
-    float str2outbd_dist(std::string s, bool* as_time);  // Ref: arinc 5.27
+    float str2outbd_dist(const std::string& s, bool* as_time);  // Ref: arinc 5.27
 
     AltMode char2alt_mode(char c);  // Ref: arinc 5.29
 
-    int str2alt(std::string s);  // Ref: arinc 5.30
+    int str2alt(const std::string& s);  // Ref: arinc 5.30
 
     SpeedMode char2spd_mode(char c);  // Ref: arinc 5.261
 
@@ -182,7 +187,8 @@ namespace libnav
         int get_pos_from_db(std::string& area_code, 
         std::shared_ptr<ArptDB> arpt_db);
 
-        void get_rwy_coords(std::string& s, std::string& area_code, 
+        // s points to the threshold location part of the record
+        void get_rwy_coords(const char* s, size_t s_len, std::string& area_code, 
             std::shared_ptr<ArptDB> arpt_db);
 
         arinc_rwy_full_t(std::string& s, std::string& area_code, 
@@ -192,6 +198,16 @@ namespace libnav
     typedef std::unordered_map<std::string, arinc_rwy_data_t> arinc_rwy_db_t;
 
 
+    struct fix_memo_entry_t
+    {
+        bool is_found;
+        waypoint_t wpt;
+    };
+
+    // Resolved fixes of one airport. Keyed by arinc_fix_entry_t::get_memo_key.
+    typedef std::unordered_map<std::string, fix_memo_entry_t> fix_memo_t;
+
+
     struct arinc_fix_entry_t
     {
         std::string fix_ident;  //Ref: arinc424 spec, section 5.13/5.23/5.144/5.271
@@ -200,7 +216,23 @@ namespace libnav
         char db_subsection;  //Ref: arinc424 spec, section 5.5
 
 
+        std::string get_memo_key();
+
+        /*
+            Function: to_waypoint_t
+            Description:
+            Resolves the fix using the data bases.
+            @param memo: optional memo of fixes that have already been resolved for
+            the same airport. Lookups that hit the memo don't touch the data bases.
+            @return true if the fix was found and written to out.
+        */
+
         bool to_waypoint_t(std::string& area_code, 
+            std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
+            arinc_rwy_db_t& rwy_db, waypoint_t *out, fix_memo_t* memo=nullptr);
+
+        // Resolves the fix without the memo
+        bool lookup_waypoint(std::string& area_code, 
             std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
             arinc_rwy_db_t& rwy_db, waypoint_t *out);
     };
@@ -310,9 +342,21 @@ namespace libnav
 
         arinc_str_t(std::vector<std::string>& in_split);
 
+        /*
+            Function: arinc_str_t
+            Description:
+            Decodes a line straight from its columns. Produces the same fields as the 
+            constructor above, but doesn't need a vector of columns. Unlike that 
+            constructor, also sets proc_name and trans_name.
+            @param line: first character of the line
+            @param cols: N_ARINC_FLT_PROC_COL columns of the line. See strutils::str_split_spans.
+        */
+
+        arinc_str_t(const char* line, const strutils::str_span_t* cols);
+
         arinc_leg_t get_leg(std::string& area_code, airport_data_t& apt_data, 
             std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
-            arinc_rwy_db_t& rwy_db);
+            arinc_rwy_db_t& rwy_db, fix_memo_t* memo=nullptr);
     };
 
 
@@ -342,11 +386,29 @@ namespace libnav
 	typedef std::set<std::string> str_set_t;
     typedef std::unordered_map<std::string, str_set_t> str_umap_t;
 
+    class Airport;
+
+    typedef std::shared_ptr<Airport> airport_ptr_t;
+    typedef std::shared_future<airport_ptr_t> airport_future_t;
+    // Called with nullptr if the airport couldn't be constructed
+    typedef std::function<void(airport_ptr_t)> airport_cb_t;
+
     class Airport
     {
         typedef std::unordered_map<std::string, std::vector<int>> trans_db_t;
         typedef std::unordered_map<std::string, trans_db_t> proc_db_t;
         typedef std::pair<std::string, ProcType> proc_typed_str_t;
+
+        struct async_load_t
+        {
+            airport_future_t future;
+            std::vector<airport_cb_t> callbacks;
+        };
+
+        // Loads that are in flight. Keyed by get_load_key.
+        static std::mutex async_load_mutex;
+        static std::unordered_map<std::string, 
+            std::shared_ptr<async_load_t>> async_loads;
         
 
     public:
@@ -360,37 +422,84 @@ namespace libnav
             std::string postfix=".dat", bool use_pr=false, appr_pref_db_t pr_db = APPR_PREF, 
             arinc_leg_t* leg_ptr=nullptr);
 
+        /*
+            Function: Airport
+            Description:
+            Loads the airport's records from a CIFP archive. Falls back to the CIFP
+            file if the archive is missing, stale for the cycle of navaid_db or doesn't
+            contain the airport.
+            @param archive: CIFP archive. May be nullptr.
+        */
+
+        Airport(std::string icao, std::shared_ptr<ArptDB> arpt_db, 
+            std::shared_ptr<NavaidDB> navaid_db, 
+            std::shared_ptr<const CifpArchive> archive, std::string cifp_path="", 
+            std::string postfix=".dat", bool use_pr=false, appr_pref_db_t pr_db = APPR_PREF, 
+            arinc_leg_t* leg_ptr=nullptr);
+
         Airport(Airport& copy, arinc_leg_t* leg_ptr=nullptr);
 
-        std::vector<std::string> get_rwys();
+        /*
+            Function: load_async
+            Description:
+            Constructs an airport on an executor so that the calling thread doesn't
+            block on file I/O and leg resolution. Concurrent requests for the same
+            airport (same ICAO, data bases, archive, path, postfix and prefix setting)
+            share one load.
+            @param on_done: optional callback. Called on the thread that finishes the load.
+            @param exec: executor to run the load on. nullptr means the default pool.
+            @param archive: optional CIFP archive to load from.
+            @return future that holds the airport. Check err_code of the airport
+            before using it.
+        */
+
+        static airport_future_t load_async(std::string icao, 
+            std::shared_ptr<ArptDB> arpt_db, std::shared_ptr<NavaidDB> navaid_db, 
+            std::string cifp_path="", std::string postfix=".dat", bool use_pr=false, 
+            appr_pref_db_t pr_db = APPR_PREF, airport_cb_t on_done=nullptr, 
+            std::shared_ptr<Executor> exec=nullptr, 
+            std::shared_ptr<const CifpArchive> archive=nullptr);
 
-        const arinc_rwy_db_t& get_rwy_db();
+        std::vector<std::string> get_rwys() const;
 
-        str_umap_t get_all_sids();
+        const arinc_rwy_db_t& get_rwy_db() const;
 
-        str_umap_t get_all_stars();
+        str_umap_t get_all_sids() const;
 
-        str_umap_t get_all_appch();
+        str_umap_t get_all_stars() const;
 
-        arinc_leg_seq_t get_sid(std::string& proc_name, std::string& trans);
+        str_umap_t get_all_appch() const;
 
-        arinc_leg_seq_t get_star(std::string& proc_name, std::string& trans);
+        arinc_leg_seq_t get_sid(const std::string& proc_name, 
+            const std::string& trans) const;
 
-        arinc_leg_seq_t get_appch(std::string& proc_name, std::string& trans);
+        arinc_leg_seq_t get_star(const std::string& proc_name, 
+            const std::string& trans) const;
 
-        str_set_t get_sid_by_rwy(std::string& rwy_id);
+        arinc_leg_seq_t get_appch(const std::string& proc_name, 
+            const std::string& trans) const;
 
-        str_set_t get_star_by_rwy(std::string& rwy_id);
+        str_set_t get_sid_by_rwy(const std::string& rwy_id) const;
 
-        str_set_t get_rwy_by_sid(std::string& sid);
+        str_set_t get_star_by_rwy(const std::string& rwy_id) const;
 
-        str_set_t get_rwy_by_star(std::string& star);
+        str_set_t get_rwy_by_sid(const std::string& sid) const;
 
-        str_set_t get_trans_by_sid(std::string& sid);
+        str_set_t get_rwy_by_star(const std::string& star) const;
 
-        str_set_t get_trans_by_star(std::string& star);
+        str_set_t get_trans_by_sid(const std::string& sid) const;
 
-        str_set_t get_trans_by_appch(std::string& appch);
+        str_set_t get_trans_by_star(const std::string& star) const;
+
+        str_set_t get_trans_by_appch(const std::string& appch) const;
+
+        /*
+            Function: get_mem_usage
+            Description:
+            @return approximate number of bytes used by the airport's procedure data
+        */
+
+        size_t get_mem_usage() const;
 
         ~Airport();
 
@@ -424,16 +533,25 @@ namespace libnav
         std::queue<proc_typed_str_t> flt_leg_strings;
 
 
-        str_umap_t get_all_proc(proc_db_t& db);
+        static std::string get_load_key(std::string& icao, ArptDB* arpt_db, 
+            NavaidDB* navaid_db, const CifpArchive* archive, std::string& cifp_path, 
+            std::string& postfix, bool use_pr);
+
+        str_umap_t get_all_proc(const proc_db_t& db) const;
+
+        arinc_leg_seq_t get_proc(const std::string& proc_name, const std::string& trans, 
+            const proc_db_t& db) const;
+
+        str_set_t get_proc_by_rwy(const std::string& rwy_id, 
+            const str_umap_t& umap) const;
 
-        arinc_leg_seq_t get_proc(std::string& proc_name, std::string& trans, 
-            proc_db_t& db);
+        str_set_t get_trans_by_proc(const std::string& proc_name, 
+            const proc_db_t& db, bool rwy=false) const;
 
-        str_set_t get_proc_by_rwy(std::string& rwy_id, 
-            str_umap_t& umap);
+        static size_t get_proc_db_mem(const proc_db_t& db);
 
-        str_set_t get_trans_by_proc(std::string& proc_name, 
-            proc_db_t db, bool rwy=false);
+        // Shrinks a self-allocated leg array to the number of legs used
+        void trim_legs();
 			
 		/*
             Function: parse_flt_legs
@@ -470,5 +588,19 @@ namespace libnav
         DbErr load_db(std::shared_ptr<ArptDB> arpt_db, 
             std::shared_ptr<NavaidDB> navaid_db, std::string& path, 
             std::string& postfix);
+
+        /*
+            Function: load_archive
+            Description:
+            Same as load_db, but takes the records from memory.
+            @param data: first byte of the airport's records
+            @param sz: number of bytes
+        */
+
+        DbErr load_archive(std::shared_ptr<ArptDB> arpt_db, 
+            std::shared_ptr<NavaidDB> navaid_db, const char* data, size_t sz);
+
+        // Queues a leg record or adds a runway record to rwy_db
+        DbErr add_record(std::string& line, std::shared_ptr<ArptDB> arpt_db);
     };
 }; // namespace libnav
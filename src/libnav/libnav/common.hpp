@@ -18,6 +18,7 @@
 #include <sstream>
 #include <fstream>
 #include "geo_utils.hpp"
+#include "str_utils.hpp"
 
 
 namespace libnav
@@ -37,7 +38,8 @@ namespace libnav
 		FILE_NOT_FOUND,
 		DATA_BASE_ERROR,
 		BAD_ALLOC,
-		PARTIAL_LOAD
+		PARTIAL_LOAD,
+		CANCELLED  // Load was stopped by cancel_load or the destructor
 	};
 
 	enum class NavaidType 
@@ -78,14 +80,68 @@ namespace libnav
 	constexpr int AIRAC_CYCLE_LINE = 2;
 	constexpr char AIRAC_WORD_SEP = ' ';
 	constexpr char AUX_ID_SEP = '_';  // Separator for ids used by hold and airway dbs.
+	constexpr size_t N_AWY_ID_COL = 3;  // id_country_type
+	constexpr size_t N_HOLD_ID_COL = 4;  // id_country_area_type
 
 	typedef uint16_t navaid_type_t;
 
 
 	struct earth_data_line_t  // General variables to describe a line of earth*.dat
 	{
-		int airac_cycle, db_version;
+		int airac_cycle=0, db_version=0;
         bool is_parsed=false, is_last=false, is_airac=false;
+
+
+		/*
+			Function: set_airac
+			Description:
+			Reads the version and the cycle from the words of a header line. Text after
+			the cycle number(e.g. "2301, build") is ignored.
+			@return true if both words start with a number
+		*/
+
+		bool set_airac(const std::string& ver_word, const std::string& cycle_word)
+		{
+			const char* cycle = cycle_word.c_str();
+			return strutils::str_to_int(ver_word, &db_version) && 
+				strutils::parse_int(cycle, cycle + cycle_word.size(), 
+				&airac_cycle).err == strutils::NumErr::NONE;
+		}
+	};
+
+	/*
+		Struct: span_t
+		Description:
+		Read-only view of contiguous elements owned by a data base.
+		It stays valid for as long as the data base isn't reloaded.
+	*/
+
+	template<typename T>
+	struct span_t
+	{
+		const T* ptr = nullptr;
+		size_t n = 0;
+
+
+		const T* begin() const
+		{
+			return ptr;
+		}
+
+		const T* end() const
+		{
+			return ptr + n;
+		}
+
+		size_t size() const
+		{
+			return n;
+		}
+
+		const T& operator[](size_t i) const
+		{
+			return ptr[i];
+		}
 	};
 
 	/*
@@ -0,0 +1,120 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for DatasetManager class.
+	DatasetManager owns a generation of NavaidDB, ArptDB, AwyDB and HoldDB and allows
+	to load a new AIRAC cycle in the background and swap it in atomically.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "arpt_db.hpp"
+#include "awy_db.hpp"
+#include "executor.hpp"
+#include "hold_db.hpp"
+#include "navaid_db.hpp"
+
+
+namespace libnav
+{
+	struct dataset_paths_t
+	{
+		std::string apt_dat, custom_apt, custom_rnw;
+		std::string fix_data, navaid_data;
+		std::string awy_data, hold_data;
+		double min_rwy_length_m = MIN_RWY_LENGTH_M;
+	};
+
+	struct dataset_t
+	{
+		uint64_t generation;
+		dataset_paths_t paths;
+
+		std::shared_ptr<ArptDB> arpt_db;
+		std::shared_ptr<NavaidDB> navaid_db;
+		std::shared_ptr<AwyDB> awy_db;
+		std::shared_ptr<HoldDB> hold_db;
+	};
+
+	typedef std::shared_ptr<const dataset_t> dataset_ptr_t;
+
+
+	class DatasetManager
+	{
+	public:
+		DatasetManager(std::shared_ptr<Executor> exec=nullptr);
+
+		/*
+			Function: get_current
+			Description:
+			Returns the current generation. The generation stays alive for as long as the
+			returned pointer (or any data base pointer taken from it) is held, so queries
+			in flight finish against the data they started with.
+			@return pointer to the current data set. nullptr if nothing has been loaded yet.
+		*/
+
+		dataset_ptr_t get_current();
+
+		uint64_t get_generation();
+
+		/*
+			Function: load
+			Description:
+			Starts loading a new data set in the background. Doesn't block. Once all data
+			bases of the new generation are usable, it replaces the current one unless a
+			newer generation has been swapped in already. The old generation is destroyed
+			on the executor when its last reader lets go of it. Older loads that are still
+			in flight are cancelled since they would be replaced anyway. Airway and hold
+			data bases are linked to the navaid data base before the swap.
+			@param paths: paths to the data base files
+			@return future that becomes ready once the load is done. Holds the first
+			error encountered or SUCCESS. DbErr::CANCELLED if a newer load superseded it.
+		*/
+
+		std::future<DbErr> load(dataset_paths_t paths);
+
+		// Cancels loads that haven't finished yet and waits for them.
+		~DatasetManager();
+
+	private:
+		std::shared_ptr<Executor> executor;
+
+		dataset_ptr_t curr_dataset;  // Accessed only with atomic_load/atomic_store
+		std::atomic<uint64_t> next_generation;
+		std::mutex swap_mutex;
+
+		std::mutex pending_mutex;
+		std::condition_variable pending_cv;
+		size_t n_pending;
+		std::vector<std::weak_ptr<dataset_t>> in_flight;
+
+
+		void on_loaded(std::shared_ptr<dataset_t> ds,
+			std::shared_ptr<std::promise<DbErr>> done);
+
+		void load_done(dataset_t* ds);
+
+		void cancel_in_flight();
+
+		static void cancel_load(dataset_t& ds);
+
+		static DbErr get_err(dataset_t& ds);
+
+		static std::vector<LoadPhase*> get_phases(dataset_t& ds, bool include_cache);
+
+		static void when_all_ready(std::vector<LoadPhase*> phases, std::function<void()> func);
+	};
+}; // namespace libnav
@@ -0,0 +1,121 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of the Executor interface and the ThreadPool class.
+	All data base load tasks are scheduled on an Executor. The host application may
+	pass its own implementation to the data base constructors to control the number of
+	threads used by libnav.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace libnav
+{
+	constexpr size_t N_POOL_THREADS_MIN = 2;
+
+
+	typedef std::function<void()> exec_task_t;
+
+
+	class Executor
+	{
+	public:
+		/*
+			Function: submit
+			Description:
+			Schedules a task. The task must eventually be run on some thread.
+			Tasks submitted by libnav never block waiting for other tasks.
+		*/
+
+		virtual void submit(exec_task_t task) = 0;
+
+		virtual size_t get_n_workers() = 0;
+
+		virtual ~Executor() {}
+	};
+
+
+	class ThreadPool : public Executor
+	/*
+		Fixed size thread pool. Every worker has its own task queue. Tasks submitted
+		from a worker go to that worker's queue, other tasks are distributed round-robin.
+		Idle workers steal tasks from the other queues.
+	*/
+	{
+		struct worker_queue_t
+		{
+			std::mutex mtx;
+			std::deque<exec_task_t> tasks;
+		};
+
+	public:
+		ThreadPool(size_t n_threads=0);  // 0 means hardware concurrency
+
+		void submit(exec_task_t task) override;
+
+		size_t get_n_workers() override;
+
+		// Runs all of the pending tasks and joins the workers.
+		~ThreadPool();
+
+	private:
+		std::vector<std::unique_ptr<worker_queue_t>> queues;
+		std::vector<std::thread> workers;
+
+		std::mutex wake_mutex;
+		std::condition_variable wake_cv;
+		std::atomic<size_t> n_pending;
+		std::atomic<size_t> next_queue;
+		bool stop;
+
+
+		void worker_loop(size_t idx);
+
+		bool try_pop(size_t idx, exec_task_t* out);
+	};
+
+
+	/*
+		Function: get_default_executor
+		Description:
+		Returns the pool shared by all data bases that weren't given an executor.
+		The pool is created on first use.
+	*/
+
+	std::shared_ptr<Executor> get_default_executor();
+
+	/*
+		Function: submit_task
+		Description:
+		Schedules a callable on an executor.
+		@return future that holds the result of the callable
+	*/
+
+	template<class F>
+	auto submit_task(Executor* ex, F func) -> std::future<decltype(func())>
+	{
+		typedef decltype(func()) ret_t;
+		// std::function needs a copyable callable.
+		auto task = std::make_shared<std::packaged_task<ret_t()>>(func);
+		std::future<ret_t> out = task->get_future();
+		ex->submit([task]() { (*task)(); });
+		return out;
+	}
+}; // namespace libnav
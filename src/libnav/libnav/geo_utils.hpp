@@ -1,324 +1,734 @@
-/*
-	This project is licensed under
-	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
-
-	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
-
-	Author: discord/bruh4096#4512
-
-	This file contains utility functions for working with lat,lon points.
-*/
-
-
-#pragma once
-
-#define _USE_MATH_DEFINES
-#include <math.h>
-
-
-namespace geo
-{
-	/*
-		Common measurement units by postfixes:
-		_deg: degrees
-		_nm: nautical miles
-		_ft: feet
-	*/
-
-	constexpr double DEG_TO_RAD = M_PI / 180.0;
-	constexpr double RAD_TO_DEG = 180.0 / M_PI;
-	constexpr double NM_TO_M = 1852;
-	constexpr double FT_TO_NM = 1 / 6076.12;
-	constexpr double M_TO_FT = 3.28084;
-	constexpr double EARTH_RADIUS_NM = 3441.0;
-
-
-	/*
-		Function: rad_to_pos_deg
-		Description:
-		Function that converts a value in radians to degrees.
-		Param:
-		rad: a value in radians
-		Return:
-		Returns a non-negative value in degrees. 
-	*/
-
-	inline double rad_to_pos_deg(double rad)
-	{
-		double out = rad * RAD_TO_DEG + 360.0;
-		while (out > 360.0)
-		{
-			out -= 360.0;
-		}
-		return out;
-	}
-
-	struct point
-	{
-		double lat_rad, lon_rad;
-
-
-		bool operator==(point const& other)
-		{
-			return lat_rad == other.lat_rad && lon_rad == other.lon_rad;
-		}
-
-		/*
-			Function: get_gc_bearing_rad
-			Description:
-			Function that calculates great circle bearing between 2 points on Earth's surface.
-			Param:
-			other: second point
-			Return:
-			Returns a great circle bearing(non-negative value)
-		*/
-
-		double get_gc_bearing_rad(point other)
-		{
-			// This is a c++ interpreation of an algorithm that can be found here:
-			// https://www.movable-type.co.uk/scripts/latlong.html
-			double lat2_rad = other.lat_rad;
-			double lon2_rad = other.lon_rad;
-			double dlon = lon2_rad - lon_rad;
-			double a = sin(dlon) * cos(lat2_rad);
-			double b = cos(lat_rad) * sin(lat2_rad) - sin(lat_rad) * cos(lat2_rad) * cos(dlon);
-			if (b == 0)
-			{
-				return 0;
-			}
-			else
-			{
-				return atan2(a, b);
-			}
-		}
-
-		/*
-			Function: get_ang_dist_rad
-			Description:
-			Function that calculates angular distance between to points on Earth's surface.
-			Param:
-			other: second point
-			Return:
-			Returns an angular distance in radians.
-		*/
-
-		double get_ang_dist_rad(point other)
-		{
-			// This is a c++ interpreation of an algorithm that can be found here:
-			// https://www.movable-type.co.uk/scripts/latlong.html
-			double lat2_rad = other.lat_rad;
-			double lon2_rad = other.lon_rad;
-			double dlon = lon2_rad - lon_rad;
-			double dlat = lat2_rad - lat_rad;
-			double a1 = sin(dlat / 2);
-			double a2 = sin(dlon / 2);
-			double a = (a1 * a1) + cos(lat_rad) * cos(lat2_rad) * (a2 * a2);
-			return 2 * atan2(sqrt(a), sqrt(1 - a));
-		}
-
-		/*
-			Function: get_gc_dist_nm
-			Description:
-			Function that calculates great circle distance between 2 points on Earth's surface.
-			Param:
-			other: second point
-			Return:
-			Returns a great circle distance(non-negative value)
-		*/
-
-		double get_gc_dist_nm(point other)
-		{
-			return get_ang_dist_rad(other) * EARTH_RADIUS_NM;
-		}
-
-		/*
-			Function: get_line_dist_nm
-			Description:
-			Function that calculates the length of a straight line segment that connects 2 points
-			Param:
-			other: second point.
-			alt1_ft: altitude of this point AMSL
-			alt2_ft: altitude of another point AMSL
-			Return:
-			Returns a non-negative distance value.
-		*/
-
-		double get_line_dist_nm(point other, double alt1_ft, double alt2_ft)
-		{
-			double elev1_nm = alt1_ft * FT_TO_NM;
-			double elev2_nm = alt2_ft * FT_TO_NM;
-			double ang_dist_rad = get_ang_dist_rad(other);
-			double a = EARTH_RADIUS_NM + elev1_nm;
-			double b = EARTH_RADIUS_NM + elev2_nm;
-			return sqrt(std::pow(a, 2) + std::pow(b, 2) - 2 * a * b * cos(ang_dist_rad));
-		}
-	};
-
-	/*
-		Function: get_pos_from_brng_dist
-		Description:
-		Function that calculates lat,long of a point given its bearing and distance from a reference point.
-		Param:
-		ref: point to which the bearing and distance are given.
-		brng_rad: bearing to ref
-		dist_nm: distance to ref
-		Return:
-		Returns an estimated position.
-	*/
-
-	inline point get_pos_from_brng_dist(point ref, double brng_rad, double dist_nm)
-	{
-		// This is a c++ interpreation of an algorithm that can be found here:
-		// https://www.movable-type.co.uk/scripts/latlong.html
-		double ref_lat_rad = ref.lat_rad;
-		double ref_lon_rad = ref.lon_rad;
-		double ang_dist_rad = dist_nm / EARTH_RADIUS_NM;
-		point ret{};
-		double tmp_lat = asin(sin(ref_lat_rad) * cos(ang_dist_rad) + 
-			cos(ref_lat_rad) * sin(ang_dist_rad) * cos(brng_rad));
-		double tmp_lon = atan2(sin(brng_rad) * sin(ang_dist_rad) * cos(ref_lat_rad),
-			cos(ang_dist_rad) - sin(ref_lat_rad) * sin(tmp_lat));
-		ret.lat_rad = tmp_lat;
-		ret.lon_rad = (ref_lon_rad + tmp_lon);
-
-		return ret;
-	}
-
-	inline point get_pos_from_intc(point ref1, point ref2, double brng1_rad, 
-		double brng2_rad)
-	{
-		// This is a c++ interpreation of an algorithm that can be found here:
-		// https://www.movable-type.co.uk/scripts/latlong.html
-		double ref1_lat_rad = ref1.lat_rad;
-		double ref1_lon_rad = ref1.lon_rad;
-
-		double ref2_lat_rad = ref2.lat_rad;
-		double ref2_lon_rad = ref2.lon_rad;
-
-		double delta_lat = ref1_lat_rad - ref2_lat_rad;
-		double delta_lon = ref1_lon_rad - ref2_lon_rad;
-		double tmp = sin(delta_lat/2)*sin(delta_lat/2)+cos(ref1_lat_rad) * 
-			cos(ref2_lat_rad) * sin(delta_lon/2)*sin(delta_lon/2);
-		double ang_dist12_rad = 2 * asin(sqrt(tmp));
-
-		double theta_a = acos((sin(ref2_lat_rad) - sin(ref1_lat_rad) * cos(ang_dist12_rad)) 
-			/ (sin(ang_dist12_rad) * cos(ref1_lat_rad)));
-		double theta_b = acos((sin(ref1_lat_rad) - sin(ref2_lat_rad) * cos(ang_dist12_rad)) 
-			/ (sin(ang_dist12_rad) * cos(ref2_lat_rad)));
-
-		double theta12 = theta_a;
-		double theta21 = 2 * M_PI - theta_b;
-		if(sin(-delta_lon) <= 0)
-		{
-			theta12 = 2 * M_PI - theta_a;
-			theta21 = theta_b;
-		}
-
-		double alpha1 = brng1_rad - theta12;
-		double alpha2 = theta21 - brng2_rad;
-
-		double alpha3 = acos(-cos(alpha1)*cos(alpha2)+sin(alpha1)*sin(alpha2)
-			*cos(ang_dist12_rad));
-		
-		double ang_dist13_rad = atan2(sin(ang_dist12_rad)*sin(alpha1)*sin(alpha2),
-			cos(alpha2)+cos(alpha1)*cos(alpha3));
-
-		double tgt_lat_rad = asin(sin(ref1_lat_rad)*cos(ang_dist13_rad)+
-			cos(ref1_lat_rad)*sin(ang_dist13_rad)*cos(brng1_rad));
-		
-		double delta_lon_tgt = atan2(sin(brng1_rad) * sin(ang_dist13_rad) * 
-			cos(ref1_lat_rad), cos(ang_dist13_rad)-sin(ref1_lat_rad)*sin(tgt_lat_rad));
-
-		double tgt_lon_rad = ref1_lon_rad + delta_lon_tgt;
-
-		return {tgt_lat_rad, tgt_lon_rad};
-	}
-
-	struct point3d
-	{
-		point p;
-		double alt_ft;
-
-		/*
-			Function: get_true_dist_nm
-			Description:
-			Function that calculates the length of a straight line segment that connects 2 points
-			Param:
-			other: second point.
-			Return:
-			Returns a non-negative distance value.
-		*/
-
-		double get_true_dist_nm(point3d other)
-		{
-			return p.get_line_dist_nm(other.p, alt_ft, other.alt_ft);
-		}
-	};
-
-	/*
-		Function: get_dme_dme_pos
-		Description:
-		Function that returns estimates of aircraft using distances from 2 points(presumably DMEs), their positions
-		and altitude of the aircraft. . This function uses an algorithm described here:
-		https://aviation.stackexchange.com/questions/46135/how-can-i-triangulate-a-position-using-two-dmes
-		Param:
-		dme_u: coordinates of westmost dme
-		dme_s: coordinates of eastmost dme
-		d_u_nm: distance from dme1 to the aircraft
-		d_s_nm: distance from dme2 to the aircraft
-		elev_u_ft: elevation of dme_u AMSL
-		elev_s_ft: elevation of dme_s AMSL
-		ac_alt_ft: barometric altitude of the aircraft
-		arr: pointer to array where the calculated estimates will be written. The array's length MUST be equal to 2,
-		since there will at most be 2 estimates of the position.
-		Return:
-		returns number of position estimates written to arr.
-	*/
-
-	inline int get_dme_dme_pos(point dme_u, point dme_s, double d_u_nm, double d_s_nm, double elev_u_ft, 
-							   double elev_s_ft, double ac_alt_ft, point* arr)
-	{
-		double lat_u_rad = dme_u.lat_rad;
-		double lon_u_rad = dme_u.lon_rad;
-		double lat_s_rad = dme_s.lat_rad;
-		double lon_s_rad = dme_s.lon_rad;
-		double lat_diff = lat_s_rad - lat_u_rad;
-		double lon_diff = lon_s_rad - lon_u_rad;
-		double a = cos(lat_s_rad) * sin(lat_u_rad);
-		double b = sin(lat_s_rad) * cos(lat_u_rad);
-
-		double elev_1_nm = elev_u_ft * FT_TO_NM;
-		double elev_2_nm = elev_s_ft * FT_TO_NM;
-		double ac_alt_nm = ac_alt_ft * FT_TO_NM;
-
-		// Step 0: Convert slant-ranges to angular distance
-		double a_u = (d_u_nm - ac_alt_nm + elev_1_nm) * (d_u_nm + ac_alt_nm - elev_1_nm);
-		double a_s = (d_s_nm - ac_alt_nm + elev_1_nm) * (d_s_nm + ac_alt_nm - elev_1_nm);
-		double b_u = (EARTH_RADIUS_NM + elev_1_nm) * (EARTH_RADIUS_NM + ac_alt_nm);
-		double b_s = (EARTH_RADIUS_NM + elev_2_nm) * (EARTH_RADIUS_NM + ac_alt_nm);
-		double theta_ua = 2 * asin(0.5 * (sqrt(a_u / b_u)));
-		double theta_sa = 2 * asin(0.5 * (sqrt(a_s / b_s)));
-		// Step 1: Solve the spherical triangle for each station
-		double sin_lat = std::pow(sin(0.5 * lat_diff), 2);
-		double sin_lon = std::pow(sin(0.5 * lon_diff), 2);
-		double theta_us = 2 * asin(sqrt(sin_lat + a * sin_lon));
-		double psi_su = atan2((cos(lat_s_rad) * sin(lon_diff)), (b - a * cos(lon_diff)));
-		// Step 2: Confirm inputs are consistent and a solution exists
-		if (theta_ua + theta_sa >= theta_us && abs(theta_ua - theta_sa) <= theta_us)
-		{
-			// Step 3: Solve the spherical triangle USA
-			double beta_u = acos((cos(theta_sa) - cos(theta_us) * cos(theta_ua)) / (sin(theta_us) * sin(theta_ua)));
-			// Step 4: With all data now available, compute aircraft latitude and longitude
-			double psi_rad[2] = { psi_su + beta_u, psi_su - beta_u };
-			for (int i = 0; i < 2; i++)
-			{
-				double tmp_1 = sin(theta_ua) * cos(psi_rad[i]);
-				arr[i].lat_rad = asin(sin(lat_u_rad) * cos(theta_ua) + cos(lat_u_rad) * tmp_1);
-				arr[i].lon_rad = (atan2(sin(psi_rad[i]) * sin(theta_ua), cos(lat_u_rad) * cos(theta_ua) - 
-					sin(lat_u_rad) * tmp_1) + lon_u_rad);
-			}
-			return 2;
-		}
-		return 0;
-	}
-}; // namespace libnav
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains utility functions for working with lat,lon points.
+*/
+
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <cstdint>
+
+
+namespace geo
+{
+	/*
+		Common measurement units by postfixes:
+		_deg: degrees
+		_nm: nautical miles
+		_ft: feet
+	*/
+
+	constexpr double DEG_TO_RAD = M_PI / 180.0;
+	constexpr double RAD_TO_DEG = 180.0 / M_PI;
+	constexpr double NM_TO_M = 1852;
+	constexpr double FT_TO_NM = 1 / 6076.12;
+	constexpr double M_TO_FT = 3.28084;
+	constexpr double EARTH_RADIUS_NM = 3441.0;
+
+
+	/*
+		Function: rad_to_pos_deg
+		Description:
+		Function that converts a value in radians to degrees.
+		Param:
+		rad: a value in radians
+		Return:
+		Returns a non-negative value in degrees. 
+	*/
+
+	inline double rad_to_pos_deg(double rad)
+	{
+		double out = rad * RAD_TO_DEG + 360.0;
+		while (out > 360.0)
+		{
+			out -= 360.0;
+		}
+		return out;
+	}
+
+	struct point
+	{
+		double lat_rad, lon_rad;
+
+
+		bool operator==(point const& other)
+		{
+			return lat_rad == other.lat_rad && lon_rad == other.lon_rad;
+		}
+
+		/*
+			Function: get_gc_bearing_rad
+			Description:
+			Function that calculates great circle bearing between 2 points on Earth's surface.
+			Param:
+			other: second point
+			Return:
+			Returns a great circle bearing(non-negative value)
+		*/
+
+		double get_gc_bearing_rad(point other)
+		{
+			// This is a c++ interpreation of an algorithm that can be found here:
+			// https://www.movable-type.co.uk/scripts/latlong.html
+			double lat2_rad = other.lat_rad;
+			double lon2_rad = other.lon_rad;
+			double dlon = lon2_rad - lon_rad;
+			double a = sin(dlon) * cos(lat2_rad);
+			double b = cos(lat_rad) * sin(lat2_rad) - sin(lat_rad) * cos(lat2_rad) * cos(dlon);
+			if (b == 0)
+			{
+				return 0;
+			}
+			else
+			{
+				return atan2(a, b);
+			}
+		}
+
+		/*
+			Function: get_ang_dist_rad
+			Description:
+			Function that calculates angular distance between to points on Earth's surface.
+			Param:
+			other: second point
+			Return:
+			Returns an angular distance in radians.
+		*/
+
+		double get_ang_dist_rad(point other)
+		{
+			// This is a c++ interpreation of an algorithm that can be found here:
+			// https://www.movable-type.co.uk/scripts/latlong.html
+			double lat2_rad = other.lat_rad;
+			double lon2_rad = other.lon_rad;
+			double dlon = lon2_rad - lon_rad;
+			double dlat = lat2_rad - lat_rad;
+			double a1 = sin(dlat / 2);
+			double a2 = sin(dlon / 2);
+			double a = (a1 * a1) + cos(lat_rad) * cos(lat2_rad) * (a2 * a2);
+			return 2 * atan2(sqrt(a), sqrt(1 - a));
+		}
+
+		/*
+			Function: get_gc_dist_nm
+			Description:
+			Function that calculates great circle distance between 2 points on Earth's surface.
+			Param:
+			other: second point
+			Return:
+			Returns a great circle distance(non-negative value)
+		*/
+
+		double get_gc_dist_nm(point other)
+		{
+			return get_ang_dist_rad(other) * EARTH_RADIUS_NM;
+		}
+
+		/*
+			Function: get_line_dist_nm
+			Description:
+			Function that calculates the length of a straight line segment that connects 2 points
+			Param:
+			other: second point.
+			alt1_ft: altitude of this point AMSL
+			alt2_ft: altitude of another point AMSL
+			Return:
+			Returns a non-negative distance value.
+		*/
+
+		double get_line_dist_nm(point other, double alt1_ft, double alt2_ft)
+		{
+			double elev1_nm = alt1_ft * FT_TO_NM;
+			double elev2_nm = alt2_ft * FT_TO_NM;
+			double ang_dist_rad = get_ang_dist_rad(other);
+			double a = EARTH_RADIUS_NM + elev1_nm;
+			double b = EARTH_RADIUS_NM + elev2_nm;
+			return sqrt(std::pow(a, 2) + std::pow(b, 2) - 2 * a * b * cos(ang_dist_rad));
+		}
+	};
+
+	/*
+		Compact coordinates:
+		packed_point stores lat/lon as 32-bit fixed point numbers. One unit is
+		pi/2^31 rad(~1.46e-9 rad). Values are rounded to the nearest unit, so
+		the error of each coordinate is at most PACKED_MAX_ERR_RAD(~7.3e-10 rad),
+		which is less than 5 mm on Earth's surface. Longitude is wrapped into [-pi, pi).
+		packed_point takes 8 bytes instead of 16 and converts to point implicitly.
+	*/
+
+	constexpr double PACKED_RAD_PER_UNIT = M_PI / 2147483648.0;
+	constexpr double PACKED_UNITS_PER_RAD = 2147483648.0 / M_PI;
+	constexpr double PACKED_MAX_ERR_RAD = PACKED_RAD_PER_UNIT / 2;
+
+
+	struct packed_point
+	{
+		int32_t lat, lon;
+
+
+		packed_point(): lat(0), lon(0) {}
+
+		packed_point(point p)
+		{
+			lat = pack_ang(p.lat_rad);
+			lon = pack_ang(p.lon_rad);
+		}
+
+		operator point() const
+		{
+			return {double(lat) * PACKED_RAD_PER_UNIT, double(lon) * PACKED_RAD_PER_UNIT};
+		}
+
+		bool operator==(packed_point const& other) const
+		{
+			return lat == other.lat && lon == other.lon;
+		}
+
+		static int32_t pack_ang(double ang_rad)
+		{
+			while (ang_rad >= M_PI)
+			{
+				ang_rad -= 2 * M_PI;
+			}
+			while (ang_rad < -M_PI)
+			{
+				ang_rad += 2 * M_PI;
+			}
+			int64_t val = int64_t(llround(ang_rad * PACKED_UNITS_PER_RAD));
+			if (val >= int64_t(2147483648))
+			{
+				val -= int64_t(4294967296);
+			}
+			return int32_t(val);
+		}
+	};
+
+	/*
+		stored_point is the type used for coordinates in waypoint, airport and runway
+		tables. Define LIBNAV_COMPACT_COORDS to store them as packed_point.
+		Always widen to point before doing any math: geo::point p = entry.pos;
+	*/
+
+#ifdef LIBNAV_COMPACT_COORDS
+	typedef packed_point stored_point;
+#else
+	typedef point stored_point;
+#endif
+
+	/*
+		Function: normalize_dlon_rad
+		Description:
+		Wraps a longitude difference into [-pi, pi].
+		Param:
+		dlon_rad: longitude difference in radians
+		Return:
+		Returns the shortest signed longitude difference.
+	*/
+
+	inline double normalize_dlon_rad(double dlon_rad)
+	{
+		while (dlon_rad > M_PI)
+		{
+			dlon_rad -= 2 * M_PI;
+		}
+		while (dlon_rad < -M_PI)
+		{
+			dlon_rad += 2 * M_PI;
+		}
+		return dlon_rad;
+	}
+
+	/*
+		Struct: dist_filter
+		Description:
+		Two-stage "is this point within dist_nm of center" check. Use it when the
+		same center is tested against many points.
+		Stage 1(maybe_in_range) compares raw lat/lon differences against a
+		bounding box that is computed once in the constructor. It never rejects a point
+		that is within range. The only false positives are the points in the corners of
+		the box, i.e. up to (sqrt(2) - 1) * dist_nm outside of the circle.
+		Stage 2(is_in_range) is exact. It compares haversine terms directly, so
+		it doesn't need atan2 or sqrt like get_gc_dist_nm does.
+	*/
+
+	struct dist_filter
+	{
+		point center;
+		double ang_dist_rad;
+		double lat_min_rad, lat_max_rad;
+		double dlon_max_rad;
+		double cos_lat_ctr;
+		double max_hav;  // Haversine of ang_dist_rad
+		bool all_lon;  // True if the circle contains a pole
+		bool all_pts;  // True if the circle covers the whole globe
+
+		dist_filter(point ctr, double dist_nm)
+		{
+			// Bounding box algorithm by Jan Philip Matuschek can be found here:
+			// http://janmatuschek.de/LatitudeLongitudeBoundingCoordinates
+			center = ctr;
+			ang_dist_rad = dist_nm / EARTH_RADIUS_NM;
+			cos_lat_ctr = cos(ctr.lat_rad);
+			all_pts = ang_dist_rad >= M_PI;
+			all_lon = false;
+			dlon_max_rad = M_PI;
+
+			double h = sin(ang_dist_rad / 2);
+			max_hav = h * h;
+
+			lat_min_rad = ctr.lat_rad - ang_dist_rad;
+			lat_max_rad = ctr.lat_rad + ang_dist_rad;
+			if (lat_min_rad <= -M_PI / 2 || lat_max_rad >= M_PI / 2)
+			{
+				all_lon = true;
+			}
+			else
+			{
+				double tmp = sin(ang_dist_rad) / cos_lat_ctr;
+				if (tmp >= 1)
+				{
+					all_lon = true;
+				}
+				else
+				{
+					dlon_max_rad = asin(tmp);
+				}
+			}
+		}
+
+		/*
+			Function: maybe_in_range
+			Description:
+			Conservative pre-filter. Doesn't use any trigonometric functions.
+			Param:
+			p: point to check
+			Return:
+			Returns false only if p is definitely farther than dist_nm from center.
+		*/
+
+		bool maybe_in_range(point p) const
+		{
+			if (all_pts)
+				return true;
+			if (p.lat_rad < lat_min_rad || p.lat_rad > lat_max_rad)
+				return false;
+			if (all_lon)
+				return true;
+			return abs(normalize_dlon_rad(p.lon_rad - center.lon_rad)) <= dlon_max_rad;
+		}
+
+		/*
+			Function: is_in_range
+			Description:
+			Exact check. Should be called only for the points that passed maybe_in_range.
+			Param:
+			p: point to check
+			Return:
+			Returns true if great circle distance between p and center doesn't
+			exceed dist_nm.
+		*/
+
+		bool is_in_range(point p) const
+		{
+			if (all_pts)
+				return true;
+			double a1 = sin((p.lat_rad - center.lat_rad) / 2);
+			double a2 = sin((p.lon_rad - center.lon_rad) / 2);
+			double a = (a1 * a1) + cos_lat_ctr * cos(p.lat_rad) * (a2 * a2);
+			return a <= max_hav;
+		}
+
+		/*
+			Function: check
+			Description:
+			Runs both stages.
+			Param:
+			p: point to check
+			Return:
+			Returns true if p is within dist_nm of center.
+		*/
+
+		bool check(point p) const
+		{
+			return maybe_in_range(p) && is_in_range(p);
+		}
+	};
+
+	/*
+		Function: get_pos_from_brng_dist
+		Description:
+		Function that calculates lat,long of a point given its bearing and distance from a reference point.
+		Param:
+		ref: point to which the bearing and distance are given.
+		brng_rad: bearing to ref
+		dist_nm: distance to ref
+		Return:
+		Returns an estimated position.
+	*/
+
+	inline point get_pos_from_brng_dist(point ref, double brng_rad, double dist_nm)
+	{
+		// This is a c++ interpreation of an algorithm that can be found here:
+		// https://www.movable-type.co.uk/scripts/latlong.html
+		double ref_lat_rad = ref.lat_rad;
+		double ref_lon_rad = ref.lon_rad;
+		double ang_dist_rad = dist_nm / EARTH_RADIUS_NM;
+		point ret{};
+		double tmp_lat = asin(sin(ref_lat_rad) * cos(ang_dist_rad) + 
+			cos(ref_lat_rad) * sin(ang_dist_rad) * cos(brng_rad));
+		double tmp_lon = atan2(sin(brng_rad) * sin(ang_dist_rad) * cos(ref_lat_rad),
+			cos(ang_dist_rad) - sin(ref_lat_rad) * sin(tmp_lat));
+		ret.lat_rad = tmp_lat;
+		ret.lon_rad = (ref_lon_rad + tmp_lon);
+
+		return ret;
+	}
+
+	inline point get_pos_from_intc(point ref1, point ref2, double brng1_rad, 
+		double brng2_rad)
+	{
+		// This is a c++ interpreation of an algorithm that can be found here:
+		// https://www.movable-type.co.uk/scripts/latlong.html
+		double ref1_lat_rad = ref1.lat_rad;
+		double ref1_lon_rad = ref1.lon_rad;
+
+		double ref2_lat_rad = ref2.lat_rad;
+		double ref2_lon_rad = ref2.lon_rad;
+
+		double delta_lat = ref1_lat_rad - ref2_lat_rad;
+		double delta_lon = ref1_lon_rad - ref2_lon_rad;
+		double tmp = sin(delta_lat/2)*sin(delta_lat/2)+cos(ref1_lat_rad) * 
+			cos(ref2_lat_rad) * sin(delta_lon/2)*sin(delta_lon/2);
+		double ang_dist12_rad = 2 * asin(sqrt(tmp));
+
+		double theta_a = acos((sin(ref2_lat_rad) - sin(ref1_lat_rad) * cos(ang_dist12_rad)) 
+			/ (sin(ang_dist12_rad) * cos(ref1_lat_rad)));
+		double theta_b = acos((sin(ref1_lat_rad) - sin(ref2_lat_rad) * cos(ang_dist12_rad)) 
+			/ (sin(ang_dist12_rad) * cos(ref2_lat_rad)));
+
+		double theta12 = theta_a;
+		double theta21 = 2 * M_PI - theta_b;
+		if(sin(-delta_lon) <= 0)
+		{
+			theta12 = 2 * M_PI - theta_a;
+			theta21 = theta_b;
+		}
+
+		double alpha1 = brng1_rad - theta12;
+		double alpha2 = theta21 - brng2_rad;
+
+		double alpha3 = acos(-cos(alpha1)*cos(alpha2)+sin(alpha1)*sin(alpha2)
+			*cos(ang_dist12_rad));
+		
+		double ang_dist13_rad = atan2(sin(ang_dist12_rad)*sin(alpha1)*sin(alpha2),
+			cos(alpha2)+cos(alpha1)*cos(alpha3));
+
+		double tgt_lat_rad = asin(sin(ref1_lat_rad)*cos(ang_dist13_rad)+
+			cos(ref1_lat_rad)*sin(ang_dist13_rad)*cos(brng1_rad));
+		
+		double delta_lon_tgt = atan2(sin(brng1_rad) * sin(ang_dist13_rad) * 
+			cos(ref1_lat_rad), cos(ang_dist13_rad)-sin(ref1_lat_rad)*sin(tgt_lat_rad));
+
+		double tgt_lon_rad = ref1_lon_rad + delta_lon_tgt;
+
+		return {tgt_lat_rad, tgt_lon_rad};
+	}
+
+	struct point3d
+	{
+		point p;
+		double alt_ft;
+
+		/*
+			Function: get_true_dist_nm
+			Description:
+			Function that calculates the length of a straight line segment that connects 2 points
+			Param:
+			other: second point.
+			Return:
+			Returns a non-negative distance value.
+		*/
+
+		double get_true_dist_nm(point3d other)
+		{
+			return p.get_line_dist_nm(other.p, alt_ft, other.alt_ft);
+		}
+	};
+
+	/*
+		Function: get_dme_ang_dist_rad
+		Description:
+		Converts a DME slant range to the angular distance between the station and 
+		the point on Earth's surface directly below the aircraft.
+		Param:
+		slant_nm: slant range reported by the DME
+		elev_ft: elevation of the DME AMSL
+		ac_alt_ft: barometric altitude of the aircraft
+		Return:
+		Returns angular distance in radians or -1 if the slant range is shorter than
+		the height difference between the aircraft and the station.
+	*/
+
+	inline double get_dme_ang_dist_rad(double slant_nm, double elev_ft, double ac_alt_ft)
+	{
+		double elev_nm = elev_ft * FT_TO_NM;
+		double ac_alt_nm = ac_alt_ft * FT_TO_NM;
+		double a = (slant_nm - ac_alt_nm + elev_nm) * (slant_nm + ac_alt_nm - elev_nm);
+		double b = (EARTH_RADIUS_NM + elev_nm) * (EARTH_RADIUS_NM + ac_alt_nm);
+		if (a < 0)
+		{
+			return -1;
+		}
+		return 2 * asin(0.5 * (sqrt(a / b)));
+	}
+
+	/*
+		Struct: dme_pair_geom
+		Description:
+		Geometry of a pair of DME stations. Everything that depends only on the stations
+		(angular distance and bearing between them) is calculated once in the constructor,
+		so solve can be called every frame with new ranges. This uses an algorithm described here:
+		https://aviation.stackexchange.com/questions/46135/how-can-i-triangulate-a-position-using-two-dmes
+	*/
+
+	struct dme_pair_geom
+	{
+		point dme_u, dme_s;
+		double elev_u_ft, elev_s_ft;
+		double sin_lat_u, cos_lat_u;
+		double theta_us;  // Angular distance between the stations
+		double sin_theta_us, cos_theta_us;
+		double psi_su;  // Bearing from dme_u to dme_s
+
+
+		dme_pair_geom(): dme_u({0, 0}), dme_s({0, 0}), elev_u_ft(0), elev_s_ft(0), 
+			sin_lat_u(0), cos_lat_u(1), theta_us(0), sin_theta_us(0), cos_theta_us(1), 
+			psi_su(0) {}
+
+		dme_pair_geom(point u, point s, double u_elev_ft, double s_elev_ft)
+		{
+			dme_u = u;
+			dme_s = s;
+			elev_u_ft = u_elev_ft;
+			elev_s_ft = s_elev_ft;
+
+			double lat_u_rad = u.lat_rad;
+			double lat_s_rad = s.lat_rad;
+			double lat_diff = lat_s_rad - lat_u_rad;
+			double lon_diff = s.lon_rad - u.lon_rad;
+			sin_lat_u = sin(lat_u_rad);
+			cos_lat_u = cos(lat_u_rad);
+			double a = cos(lat_s_rad) * sin_lat_u;
+			double b = sin(lat_s_rad) * cos_lat_u;
+
+			// Step 1: Solve the spherical triangle for each station
+			double sin_lat = std::pow(sin(0.5 * lat_diff), 2);
+			double sin_lon = std::pow(sin(0.5 * lon_diff), 2);
+			theta_us = 2 * asin(sqrt(sin_lat + cos(lat_s_rad) * cos_lat_u * sin_lon));
+			sin_theta_us = sin(theta_us);
+			cos_theta_us = cos(theta_us);
+			psi_su = atan2((cos(lat_s_rad) * sin(lon_diff)), (b - a * cos(lon_diff)));
+		}
+
+		/*
+			Function: solve
+			Description:
+			Calculates position estimates of the aircraft.
+			Param:
+			d_u_nm: slant range from dme_u to the aircraft
+			d_s_nm: slant range from dme_s to the aircraft
+			ac_alt_ft: barometric altitude of the aircraft
+			arr: pointer to array where the calculated estimates will be written. 
+			The array's length MUST be equal to 2.
+			Return:
+			returns number of position estimates written to arr.
+		*/
+
+		int solve(double d_u_nm, double d_s_nm, double ac_alt_ft, point* arr) const
+		{
+			// Step 0: Convert slant-ranges to angular distance
+			double theta_ua = get_dme_ang_dist_rad(d_u_nm, elev_u_ft, ac_alt_ft);
+			double theta_sa = get_dme_ang_dist_rad(d_s_nm, elev_s_ft, ac_alt_ft);
+			if (theta_ua < 0 || theta_sa < 0 || sin_theta_us == 0)
+			{
+				return 0;
+			}
+			// Step 2: Confirm inputs are consistent and a solution exists
+			if (theta_ua + theta_sa >= theta_us && abs(theta_ua - theta_sa) <= theta_us)
+			{
+				double sin_theta_ua = sin(theta_ua);
+				double cos_theta_ua = cos(theta_ua);
+				// Step 3: Solve the spherical triangle USA
+				double beta_u = acos((cos(theta_sa) - cos_theta_us * cos_theta_ua) / 
+					(sin_theta_us * sin_theta_ua));
+				// Step 4: With all data now available, compute aircraft latitude and longitude
+				double psi_rad[2] = { psi_su + beta_u, psi_su - beta_u };
+				for (int i = 0; i < 2; i++)
+				{
+					double tmp_1 = sin_theta_ua * cos(psi_rad[i]);
+					arr[i].lat_rad = asin(sin_lat_u * cos_theta_ua + cos_lat_u * tmp_1);
+					arr[i].lon_rad = (atan2(sin(psi_rad[i]) * sin_theta_ua, 
+						cos_lat_u * cos_theta_ua - sin_lat_u * tmp_1) + dme_u.lon_rad);
+				}
+				return 2;
+			}
+			return 0;
+		}
+	};
+
+	/*
+		Function: get_dme_dme_pos
+		Description:
+		Function that returns estimates of aircraft using distances from 2 points(presumably DMEs), their positions
+		and altitude of the aircraft. If the same pair of stations is used repeatedly,
+		construct a dme_pair_geom once and call its solve member function instead.
+		Param:
+		dme_u: coordinates of westmost dme
+		dme_s: coordinates of eastmost dme
+		d_u_nm: distance from dme1 to the aircraft
+		d_s_nm: distance from dme2 to the aircraft
+		elev_u_ft: elevation of dme_u AMSL
+		elev_s_ft: elevation of dme_s AMSL
+		ac_alt_ft: barometric altitude of the aircraft
+		arr: pointer to array where the calculated estimates will be written. The array's length MUST be equal to 2,
+		since there will at most be 2 estimates of the position.
+		Return:
+		returns number of position estimates written to arr.
+	*/
+
+	inline int get_dme_dme_pos(point dme_u, point dme_s, double d_u_nm, double d_s_nm, double elev_u_ft, 
+							   double elev_s_ft, double ac_alt_ft, point* arr)
+	{
+		dme_pair_geom pair(dme_u, dme_s, elev_u_ft, elev_s_ft);
+		return pair.solve(d_u_nm, d_s_nm, ac_alt_ft, arr);
+	}
+
+	/*
+		Function: get_dme_dme_pos_batch
+		Description:
+		Solves multiple DME/DME pairs in one call.
+		Param:
+		pairs: array of pre-calculated pair geometries
+		d_u_nm: array of slant ranges to dme_u of each pair
+		d_s_nm: array of slant ranges to dme_s of each pair
+		n_pairs: length of pairs, d_u_nm, d_s_nm and n_out
+		ac_alt_ft: barometric altitude of the aircraft
+		out: pointer to array of length 2 * n_pairs. Estimates of pair i are written 
+		to out[2*i] and out[2*i+1]
+		n_out: pointer to array where number of estimates for each pair is written
+		Return:
+		returns number of pairs that have at least 1 estimate.
+	*/
+
+	inline size_t get_dme_dme_pos_batch(const dme_pair_geom* pairs, const double* d_u_nm, 
+		const double* d_s_nm, size_t n_pairs, double ac_alt_ft, point* out, int* n_out)
+	{
+		size_t n_solved = 0;
+		for (size_t i = 0; i < n_pairs; i++)
+		{
+			n_out[i] = pairs[i].solve(d_u_nm[i], d_s_nm[i], ac_alt_ft, out + 2 * i);
+			if (n_out[i])
+			{
+				n_solved++;
+			}
+		}
+		return n_solved;
+	}
+
+	/*
+		Function: get_multi_dme_pos
+		Description:
+		Calculates a least-squares position fix from 2 or more DME ranges using 
+		Gauss-Newton iterations on a plane tangent to the current estimate.
+		With only 2 stations the result is the intersection closest to guess.
+		Param:
+		dme_pos: array of station positions
+		elev_ft: array of station elevations AMSL
+		d_nm: array of slant ranges
+		n_dme: length of dme_pos, elev_ft and d_nm
+		ac_alt_ft: barometric altitude of the aircraft
+		guess: initial estimate of the position(e.g. last known position)
+		out: pointer to where the position will be written
+		rms_nm: optional pointer. If not null, RMS of the range residuals in nm is written there.
+		max_iter: maximum number of iterations
+		Return:
+		returns true if a position was written to out. Returns false if there are 
+		less than 2 usable ranges or the station geometry is degenerate.
+	*/
+
+	inline bool get_multi_dme_pos(const point* dme_pos, const double* elev_ft, 
+		const double* d_nm, size_t n_dme, double ac_alt_ft, point guess, point* out, 
+		double* rms_nm=nullptr, int max_iter=10)
+	{
+		constexpr double MIN_STEP_NM = 0.0001;
+		constexpr double MIN_DET = 1e-9;
+
+		point curr = guess;
+		double sq_sum = 0;
+		size_t n_used = 0;
+
+		for (int it = 0; it < max_iter; it++)
+		{
+			// Normal equations (J^T * J) * dx = J^T * e, where dx=(east, north) in nm
+			double jtj_ee = 0, jtj_en = 0, jtj_nn = 0;
+			double jte_e = 0, jte_n = 0;
+			sq_sum = 0;
+			n_used = 0;
+
+			for (size_t i = 0; i < n_dme; i++)
+			{
+				double ang_rad = get_dme_ang_dist_rad(d_nm[i], elev_ft[i], ac_alt_ft);
+				if (ang_rad < 0)
+				{
+					continue;
+				}
+				double brng = curr.get_gc_bearing_rad(dme_pos[i]);
+				double err_nm = (ang_rad - curr.get_ang_dist_rad(dme_pos[i])) * EARTH_RADIUS_NM;
+				// Moving towards the station decreases the distance to it
+				double j_e = -sin(brng);
+				double j_n = -cos(brng);
+
+				jtj_ee += j_e * j_e;
+				jtj_en += j_e * j_n;
+				jtj_nn += j_n * j_n;
+				jte_e += j_e * err_nm;
+				jte_n += j_n * err_nm;
+				sq_sum += err_nm * err_nm;
+				n_used++;
+			}
+
+			double det = jtj_ee * jtj_nn - jtj_en * jtj_en;
+			if (n_used < 2 || abs(det) < MIN_DET)
+			{
+				return false;
+			}
+
+			double d_east = (jtj_nn * jte_e - jtj_en * jte_n) / det;
+			double d_north = (jtj_ee * jte_n - jtj_en * jte_e) / det;
+			double step_nm = sqrt(d_east * d_east + d_north * d_north);
+
+			curr = get_pos_from_brng_dist(curr, atan2(d_east, d_north), step_nm);
+			curr.lon_rad = normalize_dlon_rad(curr.lon_rad);
+
+			if (step_nm < MIN_STEP_NM)
+			{
+				break;
+			}
+		}
+
+		if (rms_nm != nullptr)
+		{
+			*rms_nm = sqrt(sq_sum / double(n_used));
+		}
+		*out = curr;
+		return true;
+	}
+}; // namespace libnav
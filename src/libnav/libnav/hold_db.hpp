@@ -17,9 +17,13 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
 #include <future>
 #include "str_utils.hpp"
 #include "common.hpp"
+#include "navaid_db.hpp"
+#include "executor.hpp"
+#include "load_phase.hpp"
 
 
 namespace libnav
@@ -60,10 +64,36 @@ namespace libnav
     class HoldDB
     {
     public:
-        HoldDB(std::string db_path);
+        /*
+            Function: HoldDB
+            Description:
+            Starts loading the hold data base.
+            @param db_path: path to earth_hold.dat
+            @param exec: executor to run the load task on. nullptr means the default pool.
+        */
+
+        HoldDB(std::string db_path, std::shared_ptr<Executor> exec=nullptr);
 
         DbErr get_err();
 
+        /*
+            Function: get_load_phase
+            Description:
+            Unlike get_err, the phase can be polled and waited on many times
+            and allows to register completion callbacks.
+            @return reference to the phase object
+        */
+
+        LoadPhase& get_load_phase();
+
+        /*
+            Function: cancel_load
+            Description:
+            Asks the loader to stop. It returns DbErr::CANCELLED within one line of input.
+        */
+
+        void cancel_load();
+
         int get_airac();
 
         int get_db_version();
@@ -74,14 +104,46 @@ namespace libnav
 
         std::vector<hold_data_t> get_hold_data(std::string& wpt_id);
 
+        /*
+            Function: link_navaids
+            Description:
+            Resolves the fix of every hold to its navaid data base entry, so that
+            get_hold_wpt doesn't need to parse the hold id. Both data bases must be
+            fully loaded. Must be called before the data base is shared with other threads.
+            @param navaid_db: pointer to the navaid data base. It's kept alive for
+            as long as this data base is.
+            @return number of hold fixes that weren't found in the navaid data base
+        */
+
+        size_t link_navaids(std::shared_ptr<NavaidDB> navaid_db);
+
+        bool is_linked();
+
+        /*
+            Function: get_hold_wpt
+            Description:
+            @param hold_id: hold data base id of the fix
+            @return pointer to the navaid data base entry of the fix. nullptr if the
+            fix wasn't found there or link_navaids hasn't been called.
+        */
+
+        const waypoint_entry_t* get_hold_wpt(const std::string& hold_id);
+
         // You don't need to call this one.
         // It's called by the corresponding thread that is created in the constructor.
         DbErr load_holds(std::string& db_path);
 
+        ~HoldDB();
+
     private:
-        int airac_cycle, db_version;
+        int airac_cycle = 0, db_version = 0;
         hold_db_t hold_db;
+        std::shared_ptr<NavaidDB> linked_navaid_db;
+        std::unordered_map<std::string, const waypoint_entry_t*> hold_wpts;
 
+        std::shared_ptr<Executor> executor;
         std::future<DbErr> hold_load_task;
+        LoadPhase load_phase;
+        std::atomic<bool> cancel_requested{false};
     };
 };
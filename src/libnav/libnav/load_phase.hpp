@@ -0,0 +1,67 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for LoadPhase class.
+	LoadPhase tracks completion of one stage of a data base load, e.g. waypoints
+	of NavaidDB or runways of ArptDB. Unlike the futures returned by get_err, 
+	a phase can be waited on and polled any number of times.
+*/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "common.hpp"
+
+
+namespace libnav
+{
+	typedef std::function<void(DbErr)> phase_cb_t;
+
+
+	class LoadPhase
+	{
+	public:
+		LoadPhase();
+
+		bool is_ready();
+
+		/*
+			Function: wait
+			Description:
+			Blocks until the phase is complete.
+			@return error code of the phase
+		*/
+
+		DbErr wait();
+
+		/*
+			Function: on_ready
+			Description:
+			Registers a callback that is called once the phase is complete. If the phase
+			is already complete, the callback is called right away on the calling thread.
+			Otherwise it's called on the thread that completes the phase, so it shouldn't block.
+			@param cb: callback. Receives the error code of the phase.
+		*/
+
+		void on_ready(phase_cb_t cb);
+
+		// Called by the loader. Only the first call has any effect.
+		void set_ready(DbErr err);
+
+	private:
+		std::mutex mtx;
+		std::condition_variable cv;
+		bool ready;
+		DbErr err_code;
+		std::vector<phase_cb_t> callbacks;
+	};
+}; // namespace libnav
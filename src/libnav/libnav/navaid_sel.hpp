@@ -0,0 +1,162 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for NavaidSelector class.
+	NavaidSelector keeps track of radio navaids that are in range of the aircraft
+	and picks the best candidates for radio navigation.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include "navaid_db.hpp"
+
+
+namespace radnav_util
+{
+	constexpr double NAVAID_SEL_CELL_DEG = 1;
+	constexpr double NAVAID_SEL_MAX_RANGE_NM = 500;
+	// Stations are re-checked after the aircraft has moved at least this far.
+	constexpr double NAVAID_SEL_MIN_MARGIN_NM = 0.001;
+	constexpr size_t N_NAVAID_SEL_BEST_DEF = 8;
+	constexpr size_t N_NAVAID_SEL_PAIRS_DEF = 4;
+	// Number of best DMEs that are combined into pairs.
+	constexpr size_t N_NAVAID_SEL_PAIR_CAND = 16;
+
+	constexpr libnav::NavaidType NAVAID_SEL_TYPES = libnav::NavaidType(
+		static_cast<int>(libnav::NavaidType::VHF_NAVAID) +
+		static_cast<int>(libnav::NavaidType::NDB));
+	constexpr libnav::NavaidType NAVAID_SEL_DME_TYPES = libnav::NavaidType(
+		static_cast<int>(libnav::NavaidType::DME) +
+		static_cast<int>(libnav::NavaidType::DME_ONLY) +
+		static_cast<int>(libnav::NavaidType::VOR_DME) +
+		static_cast<int>(libnav::NavaidType::ILS_DME));
+
+
+	class NavaidSelector
+	{
+		struct station_t
+		{
+			navaid_t nav;
+			double max_recv_nm;
+			bool is_watched, is_in_range;
+			uint32_t sched_ver;
+			size_t in_range_idx;
+		};
+
+		struct sched_t
+		{
+			double odo_nm;  // Value of the odometer when the station has to be re-checked
+			size_t idx;
+			uint32_t ver;
+		};
+
+		struct SchedCompare
+		{
+			bool operator()(const sched_t& s1, const sched_t& s2)
+			{
+				return s1.odo_nm > s2.odo_nm;
+			}
+		};
+
+		struct window_t
+		{
+			int lat_min, lat_max;
+			int lon_min, lon_max;
+			bool all_lon;
+			bool is_valid;
+		};
+
+	public:
+		/*
+			Function: NavaidSelector
+			Description:
+			Builds a spatial index of all VOR/DME/NDB stations. Navaids must be
+			fully loaded, i.e. get_navaid_err must have returned, before this is called.
+			@param db: pointer to the navaid data base
+			@param n_best: number of single navaids to keep
+			@param n_pairs: number of DME/DME pairs to keep
+		*/
+
+		NavaidSelector(std::shared_ptr<libnav::NavaidDB> db,
+			size_t n_best=N_NAVAID_SEL_BEST_DEF, size_t n_pairs=N_NAVAID_SEL_PAIRS_DEF);
+
+		/*
+			Function: update
+			Description:
+			Updates the set of stations in range and the best candidates. Only the
+			stations in cells that enter/leave the search window and the stations
+			that could have crossed their reception limit since the last call are checked.
+			@param ac_pos: position and barometric altitude of the aircraft
+		*/
+
+		void update(geo::point3d ac_pos);
+
+		size_t get_n_stations();
+
+		size_t get_n_in_range();
+
+		/*
+			Function: get_best_navaids
+			Description:
+			@return best navaids sorted by quality in descending order.
+		*/
+
+		const std::vector<navaid_t>& get_best_navaids();
+
+		/*
+			Function: get_best_pairs
+			Description:
+			@return best DME/DME pairs sorted by quality in descending order.
+			The navaid pointers point into the selector and are valid until
+			the next call to update.
+		*/
+
+		const std::vector<navaid_pair_t>& get_best_pairs();
+
+	private:
+		size_t n_best_navaids, n_best_pairs;
+		int n_lat_cells, n_lon_cells;
+		double watch_radius_nm;
+		double odo_nm;
+
+		bool has_prev_pos;
+		geo::point prev_pos;
+		window_t curr_window;
+
+		std::vector<station_t> stations;
+		std::unordered_map<int, std::vector<size_t>> cells;
+		std::priority_queue<sched_t, std::vector<sched_t>, SchedCompare> sched;
+		std::vector<size_t> in_range;
+
+		std::vector<navaid_t> best_navaids;
+		std::vector<navaid_t*> pair_cand;
+		std::vector<navaid_pair_t> best_pairs;
+
+
+		int get_lat_idx(double lat_deg);
+
+		int get_lon_idx(double lon_deg);
+
+		window_t get_window(geo::point pos);
+
+		static bool is_in_window(window_t& w, int lat_idx, int lon_idx);
+
+		void for_each_cell(window_t& w, window_t& excl, bool add);
+
+		void set_watched(size_t idx, bool watched);
+
+		void set_in_range(size_t idx, bool is_in);
+
+		void update_best(geo::point3d ac_pos);
+	};
+}; // namespace radnav_util
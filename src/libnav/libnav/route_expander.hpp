@@ -0,0 +1,148 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains declarations of member functions for RouteExpander class.
+	RouteExpander turns route strings like "KPDX BTG J1 OAK" into lists of legs.
+	Many routes can be expanded in parallel on an executor.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "arpt_db.hpp"
+#include "awy_db.hpp"
+#include "navaid_db.hpp"
+#include "executor.hpp"
+
+
+namespace libnav
+{
+	constexpr char ROUTE_TOKEN_SEP = ' ';
+	const std::string ROUTE_DCT = "DCT";
+
+
+	enum class RouteErr
+	{
+		NONE,
+		UNKNOWN_ID,  // Token isn't a fix, navaid, airport or airway
+		NOT_ON_AWY,  // Fix isn't on the airway next to it
+		NO_PATH,  // Airway can't be flown to the next fix or airway
+		BAD_AWY  // Airway at either end of the route or next to DCT
+	};
+
+	struct route_leg_t
+	{
+		std::string id;
+		std::string awy;  // Airway that leads to the fix. Empty for direct legs
+		waypoint_entry_t data;
+		alt_restr_t alt_restr;  // Only set for airway legs
+	};
+
+	struct route_result_t
+	{
+		std::vector<route_leg_t> legs;
+		std::vector<std::string> tokens;
+		std::vector<RouteErr> token_errs;  // One for each token
+		bool is_valid;  // true if all tokens are NONE
+	};
+
+
+	class RouteExpander
+	{
+		typedef std::vector<waypoint_entry_t> cand_list_t;
+
+		struct token_t
+		{
+			bool is_dct, is_awy;
+			uint32_t awy;
+			const cand_list_t* cands;
+			int sel;  // Index of the selected candidate. -1 if nothing is selected
+			uint32_t fix;  // AwyDB index of the selected candidate
+		};
+
+	public:
+		/*
+			Function: RouteExpander
+			Description:
+			All data bases must be fully loaded before this is called.
+			@param navaid_db: pointer to the navaid data base
+			@param awy_db: pointer to the airway data base
+			@param arpt_db: pointer to the airport data base. Can be nullptr, then
+			airports aren't recognized.
+			@param exec: executor to expand routes on. nullptr means the default pool.
+		*/
+
+		RouteExpander(std::shared_ptr<NavaidDB> navaid_db, std::shared_ptr<AwyDB> awy_db,
+			std::shared_ptr<ArptDB> arpt_db=nullptr, std::shared_ptr<Executor> exec=nullptr);
+
+		/*
+			Function: expand
+			Description:
+			Expands routes in parallel. Fix lookups are cached and shared by all
+			routes. Blocks until all routes are done, so it must not be called from
+			a task running on the expander's executor.
+			@param routes: route strings. Tokens are separated by spaces.
+			@return one result for each route, in the same order
+		*/
+
+		std::vector<route_result_t> expand(const std::vector<std::string>& routes);
+
+		/*
+			Function: expand_route
+			Description:
+			Expands a single route on the calling thread.
+			@param route: route string
+			@param scratch: pointer to airway search state. Keep one per thread.
+			@param out: pointer to the result
+		*/
+
+		void expand_route(const std::string& route, awy_scratch_t* scratch,
+			route_result_t* out);
+
+		size_t get_n_cached();
+
+	private:
+		std::shared_ptr<NavaidDB> navaid_db_ptr;
+		std::shared_ptr<AwyDB> awy_db_ptr;
+		std::shared_ptr<ArptDB> arpt_db_ptr;
+		std::shared_ptr<Executor> executor;
+
+		// Entries are never removed, so pointers to the lists stay valid.
+		std::mutex cache_mutex;
+		std::unordered_map<std::string, cand_list_t> cand_cache;
+
+
+		const cand_list_t* get_cands(const std::string& id);
+
+		uint32_t get_awy_fix(const std::string& id, const waypoint_entry_t& entry);
+
+		void add_hop_leg(uint32_t fix, const std::string& awy, alt_restr_t alt_restr,
+			route_result_t* out);
+
+		void classify_tokens(const std::string& route, route_result_t* out,
+			std::vector<token_t>* tok);
+
+		void select_cands(route_result_t* out, std::vector<token_t>* tok);
+
+		/*
+			Function: add_awy_legs
+			Description:
+			Expands the airways between 2 fix tokens.
+			@return true on success. Otherwise the error is set on the airway token.
+		*/
+
+		bool add_awy_legs(size_t from, size_t to, std::vector<token_t>& tok,
+			awy_scratch_t* scratch, std::vector<awy_hop_t>* hops, route_result_t* out);
+	};
+}; // namespace libnav
@@ -21,6 +21,13 @@
 #include <math.h>
 #include <iostream>
 #include <cstdint>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <cstdio>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 
 namespace strutils
@@ -50,42 +57,275 @@ namespace strutils
 		return s.str();
 	}
 
-	inline double strtod(std::string s)
-    {
-        size_t d_idx = 0;
+	enum class NumErr
+	{
+		NONE,
+		NO_DIGITS,  // The input doesn't start with a number
+		OUT_OF_RANGE  // The number doesn't fit into the output type
+	};
 
-        while(s[d_idx] != '.' && d_idx < s.size())
-            d_idx++;
+	struct num_result_t  // Same idea as std::from_chars_result
+	{
+		const char* ptr;  // First character after the number
+		NumErr err;
+	};
 
-        double out = 0;
-        double curr_p = 1;
+	/*
+		Function: parse_int
+		Description:
+		Parses a decimal integer at the start of [first, last). A leading sign is accepted.
+		Whitespace isn't skipped and the locale isn't used.
+		@param out: set to the number on success. Left untouched otherwise.
+		@Return: position after the number and the error code. ptr is first if there 
+		are no digits.
+	*/
 
-        bool is_neg = s[0] == '-';
-        
-        if(d_idx)
-        {
-            for(size_t i = d_idx - 1; i >= size_t(is_neg); i--)
-            {
-                out += double(s[i] - '0') * curr_p;
-                curr_p *= 10;
-                if(i == size_t(is_neg))
-                    break;
-            }
-        }
+	template<class T>
+	num_result_t parse_int(const char* first, const char* last, T* out)
+	{
+		const char* curr = first;
+		bool is_neg = false;
+		if(curr != last && (*curr == '-' || *curr == '+'))
+		{
+			is_neg = *curr == '-';
+			curr++;
+		}
 
-        curr_p = 0.1;
+		const char* digits = curr;
+		uint64_t val = 0;
+		bool overflow = false;
+		while(curr != last && *curr >= '0' && *curr <= '9')
+		{
+			uint64_t d = uint64_t(*curr - '0');
+			if(val > (UINT64_MAX - d) / 10)
+				overflow = true;
+			else
+				val = val * 10 + d;
+			curr++;
+		}
+		if(curr == digits)
+		{
+			return {first, NumErr::NO_DIGITS};
+		}
 
-        for(size_t i = d_idx+1; i < s.size(); i++)
-        {
-            out += double(s[i] - '0') * curr_p;
-            curr_p *= 0.1;
-        }
+		uint64_t max_pos = uint64_t(std::numeric_limits<T>::max());
+		uint64_t max_neg = std::numeric_limits<T>::is_signed ? max_pos + 1 : 0;
+		if(overflow || (!is_neg && val > max_pos) || (is_neg && val > max_neg))
+		{
+			return {curr, NumErr::OUT_OF_RANGE};
+		}
 
-        if(is_neg)
-            out *= -1;
+		if(is_neg && val)
+			*out = T(-int64_t(val - 1) - 1);
+		else
+			*out = T(val);
+		return {curr, NumErr::NONE};
+	}
 
-        return out;
-    }
+	/*
+		Function: parse_double
+		Description:
+		Parses a decimal number with an optional fraction and exponent(e.g. -12.5e3) 
+		at the start of [first, last). A leading sign is accepted. Whitespace isn't 
+		skipped and the locale isn't used. Numbers with up to 15 significant digits 
+		and exponents within +-22 are rounded correctly. Digits past the 19th are 
+		ignored.
+		@param out: set to the number on success. Left untouched otherwise.
+		@Return: position after the number and the error code. ptr is first if there 
+		are no digits.
+	*/
+
+	inline num_result_t parse_double(const char* first, const char* last, double* out)
+	{
+		static const double pow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+		constexpr int max_exact_exp = 22;
+		constexpr int max_n_sig = 19;  // Significant digits that fit into uint64_t
+
+		const char* curr = first;
+		bool is_neg = false;
+		if(curr != last && (*curr == '-' || *curr == '+'))
+		{
+			is_neg = *curr == '-';
+			curr++;
+		}
+
+		uint64_t mant = 0;
+		int n_sig = 0;
+		int exp10 = 0;
+		bool has_digits = false;
+		while(curr != last && *curr >= '0' && *curr <= '9')
+		{
+			has_digits = true;
+			if(n_sig < max_n_sig)
+			{
+				mant = mant * 10 + uint64_t(*curr - '0');
+				if(mant)
+					n_sig++;
+			}
+			else
+			{
+				exp10++;
+			}
+			curr++;
+		}
+		if(curr != last && *curr == '.')
+		{
+			curr++;
+			while(curr != last && *curr >= '0' && *curr <= '9')
+			{
+				has_digits = true;
+				if(n_sig < max_n_sig)
+				{
+					mant = mant * 10 + uint64_t(*curr - '0');
+					exp10--;
+					if(mant)
+						n_sig++;
+				}
+				curr++;
+			}
+		}
+		if(!has_digits)
+		{
+			return {first, NumErr::NO_DIGITS};
+		}
+
+		if(curr != last && (*curr == 'e' || *curr == 'E'))
+		{
+			int exp_val = 0;
+			num_result_t exp_res = parse_int(curr + 1, last, &exp_val);
+			if(exp_res.err == NumErr::NONE)
+			{
+				// Keeps the sum from overflowing. Such numbers are 0 or inf anyway.
+				exp10 += std::max(-100000, std::min(100000, exp_val));
+				curr = exp_res.ptr;
+			}
+			else if(exp_res.err == NumErr::OUT_OF_RANGE)
+			{
+				exp10 = curr[1] == '-' ? -100000 : 100000;
+				curr = exp_res.ptr;
+			}
+		}
+
+		double val = 0;
+		if(mant != 0)
+		{
+			if(mant <= (uint64_t(1) << 53) && exp10 >= -max_exact_exp && 
+				exp10 <= max_exact_exp)
+			{
+				// Both operands are exact, so the result is rounded correctly
+				if(exp10 < 0)
+					val = double(mant) / pow10[-exp10];
+				else
+					val = double(mant) * pow10[exp10];
+			}
+			else
+			{
+				val = double(static_cast<long double>(mant) * powl(10.0L, exp10));
+			}
+		}
+		if(std::isinf(val))
+		{
+			return {curr, NumErr::OUT_OF_RANGE};
+		}
+
+		*out = is_neg ? -val : val;
+		return {curr, NumErr::NONE};
+	}
+
+	/*
+		Function: field_to_int
+		Description:
+		Parses a whole field as an integer. The field may be padded with s_char.
+		@Return: true if the field is a number that fits into T. out is left untouched 
+		otherwise.
+	*/
+
+	template<class T>
+	bool field_to_int(const char* first, const char* last, T* out, char s_char=' ')
+	{
+		while(first != last && *first == s_char)
+			first++;
+		while(last != first && *(last - 1) == s_char)
+			last--;
+
+		T tmp = 0;
+		num_result_t res = parse_int(first, last, &tmp);
+		if(res.err != NumErr::NONE || res.ptr != last)
+		{
+			return false;
+		}
+		*out = tmp;
+		return true;
+	}
+
+	// Same as field_to_int, but for decimal numbers
+	inline bool field_to_double(const char* first, const char* last, double* out, 
+		char s_char=' ')
+	{
+		while(first != last && *first == s_char)
+			first++;
+		while(last != first && *(last - 1) == s_char)
+			last--;
+
+		double tmp = 0;
+		num_result_t res = parse_double(first, last, &tmp);
+		if(res.err != NumErr::NONE || res.ptr != last)
+		{
+			return false;
+		}
+		*out = tmp;
+		return true;
+	}
+
+	template<class T>
+	bool str_to_int(const std::string& s, T* out, char s_char=' ')
+	{
+		return field_to_int(s.data(), s.data() + s.size(), out, s_char);
+	}
+
+	inline bool str_to_double(const std::string& s, double* out, char s_char=' ')
+	{
+		return field_to_double(s.data(), s.data() + s.size(), out, s_char);
+	}
+
+	/*
+		Function: prefix_to_int
+		Description:
+		Parses the number at the start of [first, last) after skipping whitespace, 
+		the way atoi does. Doesn't depend on the locale.
+		@Return: the number or 0 if there isn't a valid one.
+	*/
+
+	inline int prefix_to_int(const char* first, const char* last)
+	{
+		while(first != last && isspace(static_cast<unsigned char>(*first)))
+			first++;
+
+		int out = 0;
+		parse_int(first, last, &out);
+		return out;
+	}
+
+	// Same as prefix_to_int, but works like atof
+	inline double prefix_to_double(const char* first, const char* last)
+	{
+		while(first != last && isspace(static_cast<unsigned char>(*first)))
+			first++;
+
+		double out = 0;
+		parse_double(first, last, &out);
+		return out;
+	}
+
+	// Parses a decimal number. Returns 0 if s isn't one.
+	inline double strtod(std::string s)
+	{
+		double out = 0;
+		str_to_double(s, &out, 0);
+		return out;
+	}
 
 	/*
 		Converts a double frequency to Boeing-style string representation
@@ -261,6 +501,217 @@ namespace strutils
 		return "E" + str_mag_var;
 	}
 
+	/*
+		Allocation-free variants of the formatters above. They write the same text into 
+		a caller-provided buffer. Like snprintf, the output is truncated to out_sz-1 
+		characters and terminated with 0, and the length of the full output is 
+		returned. N_FMT_BUF_SZ is enough for coordinates, frequencies and magnetic 
+		variations.
+	*/
+
+	constexpr size_t N_FMT_BUF_SZ = 32;
+
+
+	struct buf_writer_t  // Appends characters to a buffer. Used by the *_to_buf functions.
+	{
+		char* out;
+		size_t out_sz;
+		size_t len;
+
+
+		void put(char c)
+		{
+			if(len + 1 < out_sz)
+				out[len] = c;
+			len++;
+		}
+
+		void put(const char* c, size_t n)
+		{
+			for(size_t i = 0; i < n; i++)
+				put(c[i]);
+		}
+
+		void put_uint(uint64_t val)
+		{
+			char tmp[20];
+			size_t n = 0;
+			do
+			{
+				tmp[n++] = char('0' + val % 10);
+				val /= 10;
+			} while(val);
+			while(n)
+				put(tmp[--n]);
+		}
+
+		// Same text as std::to_string
+		void put_int(int val)
+		{
+			int64_t v = val;
+			if(v < 0)
+			{
+				put('-');
+				v = -v;
+			}
+			put_uint(uint64_t(v));
+		}
+
+		// Same text as printf("%.*f")
+		void put_fixed(double num, int precision)
+		{
+			static const uint64_t pow10[] = {1, 10, 100, 1000, 10000, 100000, 
+				1000000, 10000000, 100000000, 1000000000};
+			// Below this, num * 10^precision is off by less than 0.01
+			constexpr double max_exact = 7e13;
+
+			if(precision >= 0 && precision <= 9 && std::isfinite(num))
+			{
+				double y = std::fabs(num) * double(pow10[precision]);
+				double frac = y - std::floor(y);
+				// Halfway cases depend on digits that y doesn't have
+				if(y < max_exact && std::fabs(frac - 0.5) > 0.01)
+				{
+					uint64_t digits = uint64_t(std::floor(y + 0.5));
+					uint64_t p10 = pow10[precision];
+					if(std::signbit(num))
+						put('-');
+					put_uint(digits / p10);
+					if(precision)
+					{
+						char tmp[9];
+						uint64_t frac_digits = digits % p10;
+						for(int i = precision - 1; i >= 0; i--)
+						{
+							tmp[i] = char('0' + frac_digits % 10);
+							frac_digits /= 10;
+						}
+						put('.');
+						put(tmp, size_t(precision));
+					}
+					return;
+				}
+			}
+
+			// Fits any double with a precision of up to 255
+			char tmp[600];
+			int n = snprintf(tmp, sizeof(tmp), "%.*f", precision, num);
+			if(n > 0)
+				put(tmp, std::min(size_t(n), sizeof(tmp) - 1));
+		}
+
+		size_t finish()
+		{
+			if(out_sz)
+				out[len < out_sz ? len : out_sz - 1] = 0;
+			return len;
+		}
+	};
+
+	inline size_t double_to_buf(double num, uint8_t precision, char* out, size_t out_sz)
+	{
+		buf_writer_t w = {out, out_sz, 0};
+		w.put_fixed(num, int(precision));
+		return w.finish();
+	}
+
+	inline size_t freq_to_buf(double freq, char* out, size_t out_sz)
+	{
+		uint64_t freq_str_length = 0;
+		for (double i = 1; i <= freq; i *= 10)
+		{
+			freq_str_length++;
+		}
+		if (freq > 9999)
+		{
+			freq /= 100;
+			freq_str_length++;
+		}
+		else
+		{
+			freq_str_length += 2;
+		}
+
+		// std::to_string prints 6 decimals. Only the first freq_str_length characters are kept.
+		size_t max_len = size_t(freq_str_length);
+		buf_writer_t w = {out, std::min(out_sz, max_len + 1), 0};
+		w.put_fixed(freq, 6);
+		w.len = std::min(w.len, max_len);
+		return w.finish();
+	}
+
+	inline void deg_to_writer(double abs_deg, char deg_sbl, buf_writer_t* w)
+	{
+		int repr[3];
+
+		if (abs_deg < 10)
+		{
+			w->put('0');
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			int v = int(abs_deg);
+			repr[i] = v;
+			abs_deg -= v;
+			abs_deg *= 60;
+		}
+
+		w->put_int(repr[0]);
+		w->put(deg_sbl);
+		w->put_int(repr[1]);
+		w->put('.');
+
+		// First character of std::to_string
+		char tmp[2];
+		buf_writer_t tmp_w = {tmp, sizeof(tmp), 0};
+		tmp_w.put_fixed(round(double(repr[2]) / 10), 6);
+		if(tmp_w.finish())
+			w->put(tmp[0]);
+	}
+
+	inline size_t deg_to_buf(double abs_deg, char* out, size_t out_sz, 
+		char deg_sbl=DEGREE_SYMBOL)
+	{
+		buf_writer_t w = {out, out_sz, 0};
+		deg_to_writer(abs_deg, deg_sbl, &w);
+		return w.finish();
+	}
+
+	inline size_t lat_to_buf(double lat_deg, char* out, size_t out_sz, 
+		char deg_sbl=DEGREE_SYMBOL)
+	{
+		buf_writer_t w = {out, out_sz, 0};
+		w.put(lat_deg < 0 ? 'S' : 'N');
+		deg_to_writer(abs(lat_deg), deg_sbl, &w);
+		return w.finish();
+	}
+
+	inline size_t lon_to_buf(double lon_deg, char* out, size_t out_sz, 
+		char deg_sbl=DEGREE_SYMBOL)
+	{
+		buf_writer_t w = {out, out_sz, 0};
+		double abs_lon = abs(lon_deg);
+		w.put(lon_deg < 0 ? 'W' : 'E');
+		if (abs_lon < 100)
+		{
+			w.put('0');
+		}
+		deg_to_writer(abs_lon, deg_sbl, &w);
+		return w.finish();
+	}
+
+	inline size_t mag_var_to_buf(double mag_var_deg, char* out, size_t out_sz)
+	{
+		int mag_var_rnd = int(round(mag_var_deg));
+		int mag_var = ((mag_var_rnd) + 360) % 360;
+
+		buf_writer_t w = {out, out_sz, 0};
+		w.put(mag_var < 180 ? 'W' : 'E');
+		w.put_int(abs(mag_var_rnd));
+		return w.finish();
+	}
+
 	/*
 		Function: strip
 		Description: removes a designated character from the start and end of the string
@@ -295,51 +746,210 @@ namespace strutils
 		@Return: vector of strings
 	*/
 
-	inline std::vector<std::string> str_split(std::string& in, char sep=' ', 
-		int n_split = INT32_MAX)
+	struct str_span_t  // Column of a string: position of the first character and length
 	{
-		std::stringstream s(in);
-		std::string tmp;
-		std::vector<std::string> out;
+		size_t pos;
+		size_t len;
+	};
 
-		while(n_split && std::getline(s, tmp, sep))
+	// Strips '\r' from the column [start, end) and adds it. Used by str_split_spans.
+	inline void add_split_span(const char* in, size_t start, size_t end, 
+		str_span_t* out, size_t max_out, size_t* n_cols)
+	{
+		while(start < end && in[start] == '\r')
+			start++;
+		while(end > start && in[end-1] == '\r')
+			end--;
+		if(*n_cols < max_out)
+		{
+			out[*n_cols] = {start, end - start};
+		}
+		(*n_cols)++;
+	}
+
+	/*
+		Function: str_split_spans
+		Description: splits a line into columns, but only records where the columns 
+		are. Nothing is allocated. Empty columns are skipped and '\r' is stripped from 
+		both ends of every column. After n_split columns, the rest of the line is 
+		one column. Separators are searched 16 bytes at a time where SSE2 is available.
+		@param in: first character of the input. The input must be a single line.
+		@param in_len: number of characters in the input
+		@param sep: separator
+		@param out: array for the columns
+		@param max_out: size of out. Columns past it are counted, but not written.
+		@param n_split: maximum number of columns to separate
+		@Return: number of columns in the input
+	*/
+
+	inline size_t str_split_spans(const char* in, size_t in_len, char sep, 
+		str_span_t* out, size_t max_out, int n_split = INT32_MAX)
+	{
+		size_t n_cols = 0;
+		size_t start = 0;  // First character of the current column
+		size_t i = 0;
+
+#ifdef __SSE2__
+		const __m128i sep_v = _mm_set1_epi8(sep);
+		for(; n_split && i + 16 <= in_len; i += 16)
 		{
-			if(tmp != "")
+			__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+			unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, sep_v)));
+			while(mask && n_split)
 			{
-				n_split--;
-				out.push_back(strip(tmp, '\r'));
+				size_t sep_pos = i + size_t(__builtin_ctz(mask));
+				mask &= mask - 1;
+				if(sep_pos > start)
+				{
+					n_split--;
+					add_split_span(in, start, sep_pos, out, max_out, &n_cols);
+				}
+				start = sep_pos + 1;
 			}
 		}
-		if(!n_split)
+		if(start > i)
 		{
-			std::getline(s, tmp);
-			if(tmp.length())
-				out.push_back(strip(tmp, '\r'));
+			i = start;
 		}
+#endif
 
-		return out;
+		for(; n_split && i < in_len; i++)
+		{
+			if(in[i] == sep)
+			{
+				if(i > start)
+				{
+					n_split--;
+					add_split_span(in, start, i, out, max_out, &n_cols);
+				}
+				start = i + 1;
+			}
+		}
+		// Last column or the rest of the line after n_split columns
+		if(start < in_len)
+		{
+			add_split_span(in, start, in_len, out, max_out, &n_cols);
+		}
+
+		return n_cols;
 	}
 
-	inline int stoi_with_strip(std::string& s, char s_char=' ')
+	inline std::vector<std::string> str_split(std::string& in, char sep=' ', 
+		int n_split = INT32_MAX)
 	{
-		std::string s_stripped = strip(s, s_char);
-		if(s_stripped != "")
+		constexpr size_t n_local = 64;
+		str_span_t local[n_local];
+		str_span_t* spans = local;
+		std::vector<str_span_t> heap;
+
+		size_t n_cols = str_split_spans(in.c_str(), in.size(), sep, local, n_local, 
+			n_split);
+		if(n_cols > n_local)
 		{
-			return atoi(s_stripped.c_str());
+			heap.resize(n_cols);
+			spans = heap.data();
+			str_split_spans(in.c_str(), in.size(), sep, spans, n_cols, n_split);
 		}
 
-		return 0;
+		std::vector<std::string> out;
+		out.reserve(n_cols);
+		for(size_t i = 0; i < n_cols; i++)
+		{
+			out.emplace_back(in, spans[i].pos, spans[i].len);
+		}
+		return out;
 	}
 
-	inline float stof_with_strip(std::string& s, char s_char=' ')
+	// Removes s_char from both ends of a column
+	inline str_span_t strip_span(const char* in, str_span_t span, char s_char=' ')
 	{
-		std::string s_stripped = strip(s, s_char);
-		if(s_stripped != "")
+		while(span.len && in[span.pos] == s_char)
+		{
+			span.pos++;
+			span.len--;
+		}
+		while(span.len && in[span.pos + span.len - 1] == s_char)
 		{
-			return float(atof(s_stripped.c_str()));
+			span.len--;
 		}
+		return span;
+	}
 
-		return 0;
+	/*
+		Function: next_word
+		Description:
+		Finds the next word separated by whitespace, the way >> does on a stream.
+		@param pos: position to start from. Set to the position after the word.
+		@Return: the word. Its length is 0 if there are no words left.
+	*/
+
+	inline str_span_t next_word(const std::string& s, size_t* pos)
+	{
+		size_t i = *pos;
+		while(i < s.size() && isspace(static_cast<unsigned char>(s[i])))
+			i++;
+		size_t start = i;
+		while(i < s.size() && !isspace(static_cast<unsigned char>(s[i])))
+			i++;
+		*pos = i;
+		return {start, i - start};
+	}
+
+	// Parses the next word as an integer. Returns false if it's missing or isn't one.
+	template<class T>
+	bool next_int(const std::string& s, size_t* pos, T* out)
+	{
+		str_span_t word = next_word(s, pos);
+		return word.len && field_to_int(s.data() + word.pos, 
+			s.data() + word.pos + word.len, out, 0);
+	}
+
+	// Parses the next word as a decimal number. Returns false if it's missing or isn't one.
+	inline bool next_double(const std::string& s, size_t* pos, double* out)
+	{
+		str_span_t word = next_word(s, pos);
+		return word.len && field_to_double(s.data() + word.pos, 
+			s.data() + word.pos + word.len, out, 0);
+	}
+
+	// Same as stoi_with_strip
+	inline int span_to_int(const char* in, str_span_t span)
+	{
+		return prefix_to_int(in + span.pos, in + span.pos + span.len);
+	}
+
+	// Same as stof_with_strip
+	inline float span_to_float(const char* in, str_span_t span)
+	{
+		return float(prefix_to_double(in + span.pos, in + span.pos + span.len));
+	}
+
+	// Copies a column. Short columns fit into the string's own buffer.
+	inline void span_to_str(const char* in, str_span_t span, std::string* out)
+	{
+		out->assign(in + span.pos, span.len);
+	}
+
+	// First character of a column or 0 if it's empty
+	inline char span_first(const char* in, str_span_t span)
+	{
+		return span.len ? in[span.pos] : 0;
+	}
+
+	inline int stoi_with_strip(std::string& s, char s_char=' ')
+	{
+		size_t i = 0;
+		while(i < s.size() && s[i] == s_char)
+			i++;
+		return prefix_to_int(s.data() + i, s.data() + s.size());
+	}
+
+	inline float stof_with_strip(std::string& s, char s_char=' ')
+	{
+		size_t i = 0;
+		while(i < s.size() && s[i] == s_char)
+			i++;
+		return float(prefix_to_double(s.data() + i, s.data() + s.size()));
 	}
 
 	/*
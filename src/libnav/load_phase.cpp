@@ -0,0 +1,73 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for LoadPhase class.
+*/
+
+
+#include "libnav/load_phase.hpp"
+
+
+namespace libnav
+{
+	LoadPhase::LoadPhase()
+	{
+		ready = false;
+		err_code = DbErr::ERR_NONE;
+	}
+
+	bool LoadPhase::is_ready()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return ready;
+	}
+
+	DbErr LoadPhase::wait()
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		cv.wait(lock, [this]() { return ready; });
+		return err_code;
+	}
+
+	void LoadPhase::on_ready(phase_cb_t cb)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		if (!ready)
+		{
+			callbacks.push_back(cb);
+			return;
+		}
+		DbErr err = err_code;
+		lock.unlock();
+
+		cb(err);
+	}
+
+	void LoadPhase::set_ready(DbErr err)
+	{
+		std::vector<phase_cb_t> tmp;
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			if (ready)
+			{
+				return;
+			}
+			ready = true;
+			err_code = err;
+			tmp.swap(callbacks);
+		}
+		cv.notify_all();
+
+		// Callbacks are called without holding the lock so that they may
+		// query the phase themselves.
+		for (auto& it : tmp)
+		{
+			it(err);
+		}
+	}
+}; // namespace libnav
@@ -0,0 +1,378 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for NavaidSelector class.
+	NavaidSelector keeps track of radio navaids that are in range of the aircraft
+	and picks the best candidates for radio navigation.
+*/
+
+
+#include <functional>
+#include "libnav/navaid_sel.hpp"
+
+
+namespace radnav_util
+{
+	struct PairQualCompare
+	{
+		bool operator()(const navaid_pair_t& p1, const navaid_pair_t& p2)
+		{
+			return p1.qual > p2.qual;
+		}
+	};
+
+
+	static bool is_of_type(libnav::NavaidType tp, libnav::NavaidType mask)
+	{
+		return (static_cast<int>(tp) & static_cast<int>(mask)) != 0;
+	}
+
+
+	// NavaidSelector definitions:
+	// Public member functions:
+
+	NavaidSelector::NavaidSelector(std::shared_ptr<libnav::NavaidDB> db,
+		size_t n_best, size_t n_pairs)
+	{
+		n_best_navaids = n_best;
+		n_best_pairs = n_pairs;
+		n_lat_cells = int(180 / NAVAID_SEL_CELL_DEG);
+		n_lon_cells = int(360 / NAVAID_SEL_CELL_DEG);
+		watch_radius_nm = 0;
+		odo_nm = 0;
+		has_prev_pos = false;
+		curr_window = { 0, 0, 0, 0, false, false };
+
+		const libnav::wpt_db_t& wpts = db->get_db();
+		for (auto& it : wpts)
+		{
+			for (auto& entry : it.second)
+			{
+				if (entry.navaid == nullptr || entry.navaid->max_recv == 0 ||
+					!is_of_type(entry.type, NAVAID_SEL_TYPES))
+				{
+					continue;
+				}
+
+				station_t tmp;
+				tmp.nav = { it.first, entry, -1 };
+				tmp.max_recv_nm = entry.navaid->max_recv;
+				tmp.is_watched = false;
+				tmp.is_in_range = false;
+				tmp.sched_ver = 0;
+				tmp.in_range_idx = 0;
+
+				if (tmp.max_recv_nm > watch_radius_nm)
+				{
+					watch_radius_nm = tmp.max_recv_nm;
+				}
+
+				geo::point pos = entry.pos;
+				int lat_idx = get_lat_idx(pos.lat_rad * geo::RAD_TO_DEG);
+				int lon_idx = get_lon_idx(pos.lon_rad * geo::RAD_TO_DEG);
+				cells[lat_idx * n_lon_cells + lon_idx].push_back(stations.size());
+				stations.push_back(tmp);
+			}
+		}
+
+		if (watch_radius_nm > NAVAID_SEL_MAX_RANGE_NM)
+		{
+			watch_radius_nm = NAVAID_SEL_MAX_RANGE_NM;
+		}
+	}
+
+	void NavaidSelector::update(geo::point3d ac_pos)
+	{
+		if (has_prev_pos)
+		{
+			odo_nm += prev_pos.get_gc_dist_nm(ac_pos.p);
+		}
+		prev_pos = ac_pos.p;
+		has_prev_pos = true;
+
+		window_t new_window = get_window(ac_pos.p);
+		if (!curr_window.is_valid || new_window.lat_min != curr_window.lat_min ||
+			new_window.lat_max != curr_window.lat_max ||
+			new_window.lon_min != curr_window.lon_min ||
+			new_window.lon_max != curr_window.lon_max ||
+			new_window.all_lon != curr_window.all_lon)
+		{
+			for_each_cell(curr_window, new_window, false);
+			for_each_cell(new_window, curr_window, true);
+			curr_window = new_window;
+		}
+
+		// Only re-check the stations that could have crossed their reception limit
+		while (!sched.empty() && sched.top().odo_nm <= odo_nm)
+		{
+			sched_t curr = sched.top();
+			sched.pop();
+
+			station_t& st = stations[curr.idx];
+			if (!st.is_watched || st.sched_ver != curr.ver)
+				continue;
+
+			double dist_nm = ac_pos.p.get_gc_dist_nm(st.nav.data.pos);
+			set_in_range(curr.idx, dist_nm <= st.max_recv_nm);
+
+			double margin_nm = std::abs(dist_nm - st.max_recv_nm);
+			if (margin_nm < NAVAID_SEL_MIN_MARGIN_NM)
+			{
+				margin_nm = NAVAID_SEL_MIN_MARGIN_NM;
+			}
+			sched.push({ odo_nm + margin_nm, curr.idx, curr.ver });
+		}
+
+		update_best(ac_pos);
+	}
+
+	size_t NavaidSelector::get_n_stations()
+	{
+		return stations.size();
+	}
+
+	size_t NavaidSelector::get_n_in_range()
+	{
+		return in_range.size();
+	}
+
+	const std::vector<navaid_t>& NavaidSelector::get_best_navaids()
+	{
+		return best_navaids;
+	}
+
+	const std::vector<navaid_pair_t>& NavaidSelector::get_best_pairs()
+	{
+		return best_pairs;
+	}
+
+	// Private member functions:
+
+	int NavaidSelector::get_lat_idx(double lat_deg)
+	{
+		int idx = int(std::floor((lat_deg + 90) / NAVAID_SEL_CELL_DEG));
+		if (idx < 0)
+			return 0;
+		if (idx >= n_lat_cells)
+			return n_lat_cells - 1;
+		return idx;
+	}
+
+	int NavaidSelector::get_lon_idx(double lon_deg)
+	{
+		int idx = int(std::floor((lon_deg + 180) / NAVAID_SEL_CELL_DEG)) % n_lon_cells;
+		if (idx < 0)
+			idx += n_lon_cells;
+		return idx;
+	}
+
+	/*
+		Function: get_window
+		Description:
+		Returns the range of grid cells that contain all points within
+		watch_radius_nm of pos.
+	*/
+
+	NavaidSelector::window_t NavaidSelector::get_window(geo::point pos)
+	{
+		window_t out;
+		double r_deg = watch_radius_nm / 60;
+		double lat_deg = pos.lat_rad * geo::RAD_TO_DEG;
+		double lon_deg = pos.lon_rad * geo::RAD_TO_DEG;
+		double lat_lo = lat_deg - r_deg;
+		double lat_hi = lat_deg + r_deg;
+
+		out.lat_min = get_lat_idx(lat_lo);
+		out.lat_max = get_lat_idx(lat_hi);
+		out.is_valid = true;
+		out.all_lon = false;
+
+		double max_abs_lat = std::max(std::abs(lat_lo), std::abs(lat_hi));
+		if (max_abs_lat >= 89)
+		{
+			out.all_lon = true;
+		}
+		else
+		{
+			double dlon_deg = r_deg / cos(max_abs_lat * geo::DEG_TO_RAD);
+			if (2 * dlon_deg + 2 * NAVAID_SEL_CELL_DEG >= 360)
+			{
+				out.all_lon = true;
+			}
+			else
+			{
+				out.lon_min = get_lon_idx(lon_deg - dlon_deg);
+				out.lon_max = get_lon_idx(lon_deg + dlon_deg);
+			}
+		}
+
+		if (out.all_lon)
+		{
+			out.lon_min = 0;
+			out.lon_max = n_lon_cells - 1;
+		}
+
+		return out;
+	}
+
+	bool NavaidSelector::is_in_window(window_t& w, int lat_idx, int lon_idx)
+	{
+		if (!w.is_valid || lat_idx < w.lat_min || lat_idx > w.lat_max)
+			return false;
+		if (w.all_lon)
+			return true;
+		if (w.lon_min <= w.lon_max)
+			return lon_idx >= w.lon_min && lon_idx <= w.lon_max;
+		// Window wraps around the anti-meridian
+		return lon_idx >= w.lon_min || lon_idx <= w.lon_max;
+	}
+
+	/*
+		Function: for_each_cell
+		Description:
+		Adds/removes stations of every cell that is in w but not in excl
+		to/from the watched set.
+	*/
+
+	void NavaidSelector::for_each_cell(window_t& w, window_t& excl, bool add)
+	{
+		if (!w.is_valid)
+			return;
+
+		for (int i = w.lat_min; i <= w.lat_max; i++)
+		{
+			int j = w.lon_min;
+			while (true)
+			{
+				if (!is_in_window(excl, i, j))
+				{
+					auto it = cells.find(i * n_lon_cells + j);
+					if (it != cells.end())
+					{
+						for (auto idx : it->second)
+						{
+							set_watched(idx, add);
+						}
+					}
+				}
+
+				if (j == w.lon_max)
+					break;
+				j = (j + 1) % n_lon_cells;
+			}
+		}
+	}
+
+	void NavaidSelector::set_watched(size_t idx, bool watched)
+	{
+		station_t& st = stations[idx];
+		st.is_watched = watched;
+		// Invalidates any pending schedule entries
+		st.sched_ver++;
+
+		if (watched)
+		{
+			sched.push({ odo_nm, idx, st.sched_ver });
+		}
+		else
+		{
+			set_in_range(idx, false);
+		}
+	}
+
+	void NavaidSelector::set_in_range(size_t idx, bool is_in)
+	{
+		station_t& st = stations[idx];
+		if (st.is_in_range == is_in)
+			return;
+
+		st.is_in_range = is_in;
+		if (is_in)
+		{
+			st.in_range_idx = in_range.size();
+			in_range.push_back(idx);
+		}
+		else
+		{
+			size_t last = in_range.back();
+			in_range[st.in_range_idx] = last;
+			stations[last].in_range_idx = st.in_range_idx;
+			in_range.pop_back();
+		}
+	}
+
+	void NavaidSelector::update_best(geo::point3d ac_pos)
+	{
+		// Heaps hold (quality, station index) so that only the final
+		// candidates get copied.
+		typedef std::pair<double, size_t> qual_idx_t;
+		std::priority_queue<qual_idx_t, std::vector<qual_idx_t>,
+			std::greater<qual_idx_t>> best_q;
+		std::priority_queue<qual_idx_t, std::vector<qual_idx_t>,
+			std::greater<qual_idx_t>> dme_q;
+
+		for (auto idx : in_range)
+		{
+			navaid_t& nav = stations[idx].nav;
+			nav.calc_qual(ac_pos);
+			if (nav.qual < 0)
+				continue;
+
+			if (n_best_navaids)
+			{
+				best_q.push({ nav.qual, idx });
+				if (best_q.size() > n_best_navaids)
+					best_q.pop();
+			}
+			if (n_best_pairs && is_of_type(nav.data.type, NAVAID_SEL_DME_TYPES))
+			{
+				dme_q.push({ nav.qual, idx });
+				if (dme_q.size() > N_NAVAID_SEL_PAIR_CAND)
+					dme_q.pop();
+			}
+		}
+
+		best_navaids.resize(best_q.size());
+		for (size_t i = best_navaids.size(); i > 0; i--)
+		{
+			best_navaids[i - 1] = stations[best_q.top().second].nav;
+			best_q.pop();
+		}
+
+		pair_cand.clear();
+		while (!dme_q.empty())
+		{
+			pair_cand.push_back(&stations[dme_q.top().second].nav);
+			dme_q.pop();
+		}
+
+		std::priority_queue<navaid_pair_t, std::vector<navaid_pair_t>,
+			PairQualCompare> pair_q;
+		for (size_t i = 0; i < pair_cand.size(); i++)
+		{
+			for (size_t j = i + 1; j < pair_cand.size(); j++)
+			{
+				navaid_pair_t tmp = { pair_cand[i], pair_cand[j], -1 };
+				tmp.calc_qual(ac_pos.p);
+				if (tmp.qual < 0)
+					continue;
+
+				pair_q.push(tmp);
+				if (pair_q.size() > n_best_pairs)
+					pair_q.pop();
+			}
+		}
+
+		best_pairs.resize(pair_q.size());
+		for (size_t i = best_pairs.size(); i > 0; i--)
+		{
+			best_pairs[i - 1] = pair_q.top();
+			pair_q.pop();
+		}
+	}
+}; // namespace radnav_util
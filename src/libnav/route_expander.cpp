@@ -0,0 +1,350 @@
+/*
+	This project is licensed under
+	Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Public License (CC BY-NC-SA 4.0).
+
+	A SUMMARY OF THIS LICENSE CAN BE FOUND HERE: https://creativecommons.org/licenses/by-nc-sa/4.0/
+
+	Author: discord/bruh4096#4512
+
+	This file contains definitions of member functions for RouteExpander class.
+*/
+
+
+#include <limits>
+#include "libnav/route_expander.hpp"
+
+
+namespace libnav
+{
+	// RouteExpander definitions:
+	// Public member functions:
+
+	RouteExpander::RouteExpander(std::shared_ptr<NavaidDB> navaid_db,
+		std::shared_ptr<AwyDB> awy_db, std::shared_ptr<ArptDB> arpt_db,
+		std::shared_ptr<Executor> exec)
+	{
+		navaid_db_ptr = navaid_db;
+		awy_db_ptr = awy_db;
+		arpt_db_ptr = arpt_db;
+
+		executor = exec;
+		if (executor == nullptr)
+		{
+			executor = get_default_executor();
+		}
+	}
+
+	std::vector<route_result_t> RouteExpander::expand(const std::vector<std::string>& routes)
+	{
+		std::vector<route_result_t> out(routes.size());
+		size_t n_tasks = std::min(executor->get_n_workers(), routes.size());
+		if (n_tasks == 0)
+		{
+			n_tasks = 1;
+		}
+
+		// Routes are handed out one by one, so long routes don't hold up a whole task.
+		std::atomic<size_t> next_route(0);
+		std::vector<std::future<void>> done;
+		for (size_t i = 0; i < n_tasks; i++)
+		{
+			done.push_back(submit_task(executor.get(), [this, &routes, &out, &next_route]() {
+				awy_scratch_t scratch;
+				size_t j;
+				while ((j = next_route.fetch_add(1)) < routes.size())
+				{
+					expand_route(routes[j], &scratch, &out[j]);
+				}
+			}));
+		}
+		for (size_t i = 0; i < done.size(); i++)
+		{
+			done[i].get();
+		}
+
+		return out;
+	}
+
+	void RouteExpander::expand_route(const std::string& route, awy_scratch_t* scratch,
+		route_result_t* out)
+	{
+		std::vector<token_t> tok;
+		std::vector<awy_hop_t> hops;
+
+		out->legs.clear();
+		classify_tokens(route, out, &tok);
+		select_cands(out, &tok);
+
+		size_t prev = 0;
+		bool has_prev = false;
+		for (size_t i = 0; i < tok.size(); i++)
+		{
+			if (tok[i].is_dct || tok[i].is_awy)
+			{
+				continue;
+			}
+			if (tok[i].sel < 0)
+			{
+				// Airways can't be expanded across a fix that wasn't found
+				has_prev = false;
+				continue;
+			}
+
+			bool is_awy_leg = has_prev && tok[i - 1].is_awy;
+			if (!is_awy_leg || !add_awy_legs(prev, i, tok, scratch, &hops, out))
+			{
+				route_leg_t leg;
+				leg.id = out->tokens[i];
+				leg.data = tok[i].cands->at(size_t(tok[i].sel));
+				leg.alt_restr = { 0, 0 };
+				out->legs.push_back(leg);
+			}
+
+			prev = i;
+			has_prev = true;
+		}
+
+		out->is_valid = true;
+		for (size_t i = 0; i < out->token_errs.size(); i++)
+		{
+			if (out->token_errs[i] != RouteErr::NONE)
+			{
+				out->is_valid = false;
+			}
+		}
+	}
+
+	size_t RouteExpander::get_n_cached()
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		return cand_cache.size();
+	}
+
+	// Private member functions:
+
+	const RouteExpander::cand_list_t* RouteExpander::get_cands(const std::string& id)
+	{
+		{
+			std::lock_guard<std::mutex> lock(cache_mutex);
+			auto it = cand_cache.find(id);
+			if (it != cand_cache.end())
+			{
+				return &it->second;
+			}
+		}
+
+		// The lock isn't held during the lookup so that hits aren't blocked by it.
+		cand_list_t cands;
+		std::string tmp = id;
+		navaid_db_ptr->get_wpt_data(tmp, &cands);
+		airport_data_t apt_data;
+		if (arpt_db_ptr != nullptr && arpt_db_ptr->get_airport_data(id, &apt_data))
+		{
+			waypoint_entry_t apt;
+			apt.type = NavaidType::APT;
+			apt.pos = apt_data.pos;
+			cands.push_back(apt);
+		}
+
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		// If someone else has added it in the meantime, emplace keeps their list.
+		return &cand_cache.emplace(id, cands).first->second;
+	}
+
+	uint32_t RouteExpander::get_awy_fix(const std::string& id, const waypoint_entry_t& entry)
+	{
+		waypoint_t wpt = { id, entry };
+		return awy_db_ptr->get_fix_idx(wpt.get_awy_id());
+	}
+
+	void RouteExpander::add_hop_leg(uint32_t fix, const std::string& awy,
+		alt_restr_t alt_restr, route_result_t* out)
+	{
+		const std::string& uid = awy_db_ptr->get_fix_uid(fix);
+		route_leg_t leg;
+		leg.id = uid.substr(0, uid.find(AUX_ID_SEP));
+		leg.awy = awy;
+		leg.alt_restr = alt_restr;
+
+		const waypoint_entry_t* wpt = awy_db_ptr->get_fix_wpt(fix);
+		if (wpt != nullptr)
+		{
+			leg.data = *wpt;
+		}
+		else
+		{
+			// Airway data base isn't linked to the navaid data base
+			const cand_list_t* cands = get_cands(leg.id);
+			for (size_t i = 0; i < cands->size(); i++)
+			{
+				if (get_awy_fix(leg.id, cands->at(i)) == fix)
+				{
+					leg.data = cands->at(i);
+					break;
+				}
+			}
+		}
+		out->legs.push_back(leg);
+	}
+
+	void RouteExpander::classify_tokens(const std::string& route, route_result_t* out,
+		std::vector<token_t>* tok)
+	{
+		std::string tmp = route;
+		out->tokens = strutils::str_split(tmp, ROUTE_TOKEN_SEP);
+		size_t n_tokens = out->tokens.size();
+		out->token_errs.assign(n_tokens, RouteErr::NONE);
+		tok->assign(n_tokens, { false, false, AWY_IDX_NONE, nullptr, -1, AWY_IDX_NONE });
+
+		for (size_t i = 0; i < n_tokens; i++)
+		{
+			const std::string& curr = out->tokens[i];
+			token_t& t = tok->at(i);
+			if (curr == ROUTE_DCT)
+			{
+				t.is_dct = true;
+				continue;
+			}
+
+			t.awy = awy_db_ptr->get_awy_idx(curr);
+			if (t.awy != AWY_IDX_NONE && i > 0 && i + 1 < n_tokens &&
+				out->tokens[i - 1] != ROUTE_DCT && out->tokens[i + 1] != ROUTE_DCT)
+			{
+				t.is_awy = true;
+				continue;
+			}
+
+			t.cands = get_cands(curr);
+			if (t.cands->size() == 0)
+			{
+				out->token_errs[i] = t.awy != AWY_IDX_NONE ? RouteErr::BAD_AWY :
+					RouteErr::UNKNOWN_ID;
+			}
+		}
+	}
+
+	void RouteExpander::select_cands(route_result_t* out, std::vector<token_t>* tok)
+	{
+		std::vector<token_t>& t = *tok;
+		geo::point prev_pos = { 0, 0 };
+		bool has_prev_pos = false;
+		for (size_t i = 0; i < t.size(); i++)
+		{
+			if (t[i].cands == nullptr || t[i].cands->size() == 0)
+			{
+				continue;
+			}
+
+			uint32_t in_awy = AWY_IDX_NONE;
+			uint32_t out_awy = AWY_IDX_NONE;
+			if (i > 0 && t[i - 1].is_awy)
+			{
+				in_awy = t[i - 1].awy;
+			}
+			if (i + 1 < t.size() && t[i + 1].is_awy)
+			{
+				out_awy = t[i + 1].awy;
+			}
+
+			// Without a previous fix the candidate closest to the next fix is used.
+			const cand_list_t* next_cands = nullptr;
+			for (size_t j = i + 1; !has_prev_pos && j < t.size(); j++)
+			{
+				if (t[j].cands != nullptr && t[j].cands->size())
+				{
+					next_cands = t[j].cands;
+					break;
+				}
+			}
+
+			const cand_list_t& cands = *t[i].cands;
+			bool best_on_awy = false;
+			double best_dist = std::numeric_limits<double>::infinity();
+			for (size_t k = 0; k < cands.size(); k++)
+			{
+				uint32_t fix = AWY_IDX_NONE;
+				bool on_awy = true;
+				if (in_awy != AWY_IDX_NONE || out_awy != AWY_IDX_NONE)
+				{
+					fix = get_awy_fix(out->tokens[i], cands[k]);
+					on_awy = fix != AWY_IDX_NONE &&
+						(in_awy == AWY_IDX_NONE || awy_db_ptr->is_in_awy(in_awy, fix)) &&
+						(out_awy == AWY_IDX_NONE || awy_db_ptr->is_in_awy(out_awy, fix));
+				}
+
+				geo::point pos = cands[k].pos;
+				double dist = 0;
+				if (has_prev_pos)
+				{
+					dist = pos.get_gc_dist_nm(prev_pos);
+				}
+				else if (next_cands != nullptr)
+				{
+					dist = std::numeric_limits<double>::infinity();
+					for (size_t j = 0; j < next_cands->size(); j++)
+					{
+						dist = std::min(dist, pos.get_gc_dist_nm(next_cands->at(j).pos));
+					}
+				}
+
+				if (t[i].sel < 0 || (on_awy && !best_on_awy) ||
+					(on_awy == best_on_awy && dist < best_dist))
+				{
+					t[i].sel = int(k);
+					t[i].fix = on_awy ? fix : AWY_IDX_NONE;
+					best_on_awy = on_awy;
+					best_dist = dist;
+				}
+			}
+
+			if (!best_on_awy)
+			{
+				out->token_errs[i] = RouteErr::NOT_ON_AWY;
+			}
+			prev_pos = cands[size_t(t[i].sel)].pos;
+			has_prev_pos = true;
+		}
+	}
+
+	bool RouteExpander::add_awy_legs(size_t from, size_t to, std::vector<token_t>& tok,
+		awy_scratch_t* scratch, std::vector<awy_hop_t>* hops, route_result_t* out)
+	{
+		uint32_t start = tok[from].fix;
+		if (start == AWY_IDX_NONE || tok[to].fix == AWY_IDX_NONE)
+		{
+			return false;
+		}
+
+		// Consecutive airways are joined at their first intersection
+		size_t base = out->legs.size();
+		for (size_t i = from + 1; i < to; i++)
+		{
+			hops->clear();
+			size_t n_hops;
+			if (i + 1 < to)
+			{
+				n_hops = awy_db_ptr->get_aa_path(tok[i].awy, start, tok[i + 1].awy,
+					scratch, hops);
+			}
+			else
+			{
+				n_hops = awy_db_ptr->get_ww_path(tok[i].awy, start, tok[to].fix,
+					scratch, hops);
+			}
+			if (n_hops == 0)
+			{
+				out->token_errs[i] = RouteErr::NO_PATH;
+				out->legs.resize(base);
+				return false;
+			}
+
+			// The restriction of a leg is the one of the segment that leads to its fix
+			for (size_t k = 1; k < n_hops; k++)
+			{
+				add_hop_leg(hops->at(k).fix, out->tokens[i], hops->at(k - 1).alt_restr, out);
+			}
+			start = hops->back().fix;
+		}
+		return true;
+	}
+}; // namespace libnav
@@ -2,9 +2,18 @@
 #include <memory>
 #include <string>
 #include <libnav/awy_db.hpp>
+#include <libnav/awy_router.hpp>
 #include <libnav/hold_db.hpp>
 #include <libnav/cifp_parser.hpp>
 #include <libnav/geo_utils.hpp>
+#include <libnav/navaid_sel.hpp>
+#include <libnav/dataset_mgr.hpp>
+#include <libnav/arpt_cache.hpp>
+#include <libnav/route_expander.hpp>
+#include <chrono>
+#include <map>
+#include <random>
+#include <thread>
 
 #define UNUSED(x) (void)(x)
 
@@ -26,11 +35,15 @@ namespace dbg
 
         std::shared_ptr<libnav::AwyDB> awy_db;
         std::shared_ptr<libnav::HoldDB> hold_db;
+        std::shared_ptr<libnav::AwyRouter> awy_router;  // Built on first use
 
         std::unordered_map<std::string, std::string> env_vars;
 
         std::string cifp_dir_path;
 
+        std::string apt_dat_path, custom_apt_path, custom_rnw_path;
+        std::string fix_data_path, navaid_data_path, awy_data_path, hold_data_path;
+
 
         Avionics(std::string apt_dat, std::string custom_apt, std::string custom_rnw,
             std::string fix_data, std::string navaid_data, std::string awy_data,
@@ -43,6 +56,14 @@ namespace dbg
 
             cifp_dir_path = cifp_path;
 
+            apt_dat_path = apt_dat;
+            custom_apt_path = custom_apt;
+            custom_rnw_path = custom_rnw;
+            fix_data_path = fix_data;
+            navaid_data_path = navaid_data;
+            awy_data_path = awy_data;
+            hold_data_path = hold_data;
+
             ac_lat = def_lat;
             ac_lon = def_lon;
 
@@ -59,6 +80,9 @@ namespace dbg
             libnav::DbErr err_awy = awy_db->get_err();
             libnav::DbErr err_hold = hold_db->get_err();
 
+            awy_db->link_navaids(navaid_db_ptr);
+            hold_db->link_navaids(navaid_db_ptr);
+
             std::cout << navaid_db_ptr->get_wpt_cycle() << " " <<
                 navaid_db_ptr->get_navaid_cycle() << " " << 
                 awy_db->get_airac() << " " << hold_db->get_airac() << "\n";
@@ -104,8 +128,25 @@ namespace dbg
             update_pos();
         }
 
+        std::shared_ptr<libnav::AwyRouter> get_awy_router()
+        {
+            if(awy_router == nullptr)
+            {
+                auto start = std::chrono::steady_clock::now();
+                awy_router = std::make_shared<libnav::AwyRouter>(awy_db, navaid_db_ptr);
+                double build_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count()) / 1000;
+                std::cout << "Airway router: " << awy_router->get_n_nodes() << " fixes " <<
+                    awy_router->get_n_edges() << " segments " << 
+                    awy_router->get_n_unresolved() << " unresolved, built in " << 
+                    build_ms << " ms\n";
+            }
+            return awy_router;
+        }
+
         ~Avionics()
         {
+            awy_router.reset();
             hold_db.reset();
             awy_db.reset();
             navaid_db_ptr.reset();
@@ -205,9 +246,10 @@ namespace dbg
 
         if (n_arpts_found)
         {
-            std::string lat_str = strutils::lat_to_str(found_arpt.pos.lat_rad 
+            geo::point arpt_pos = found_arpt.pos;
+            std::string lat_str = strutils::lat_to_str(arpt_pos.lat_rad 
                 * geo::RAD_TO_DEG);
-            std::string lon_str = strutils::lon_to_str(found_arpt.pos.lon_rad 
+            std::string lon_str = strutils::lon_to_str(arpt_pos.lon_rad 
                 * geo::RAD_TO_DEG);
             std::cout << poi_id << " " << lat_str << " " << lon_str << "\n";
         }
@@ -218,9 +260,10 @@ namespace dbg
 
             for (size_t i = 0; i < n_wpts_found; i++)
             {
-                std::string lat_str = strutils::lat_to_str(found_wpts[i].pos.lat_rad 
+                geo::point wpt_pos = found_wpts[i].pos;
+                std::string lat_str = strutils::lat_to_str(wpt_pos.lat_rad 
                     * geo::RAD_TO_DEG);
-                std::string lon_str = strutils::lon_to_str(found_wpts[i].pos.lon_rad 
+                std::string lon_str = strutils::lon_to_str(wpt_pos.lon_rad 
                     * geo::RAD_TO_DEG);
                 libnav::NavaidType wpt_type = found_wpts[i].type;
                 std::string type_str = libnav::navaid_to_str(wpt_type);
@@ -233,9 +276,9 @@ namespace dbg
                 {
                     libnav::navaid_entry_t* navaid_data = found_wpts[i].navaid;
                     double freq = navaid_data->freq;
-                    std::string lat_dms = strutils::lat_to_str(found_wpts[i].pos.lat_rad
+                    std::string lat_dms = strutils::lat_to_str(wpt_pos.lat_rad
                         * geo::RAD_TO_DEG);
-                    std::string lon_dms = strutils::lon_to_str(found_wpts[i].pos.lon_rad
+                    std::string lon_dms = strutils::lon_to_str(wpt_pos.lon_rad
                         * geo::RAD_TO_DEG);
                     std::cout << poi_id << " " << lat_dms << " " << lon_dms << " " << type_str << " " << 
                         strutils::freq_to_str(freq) << "\n";
@@ -248,46 +291,1783 @@ namespace dbg
         }
     }
 
-    inline void get_path(Avionics* av, std::vector<std::string>& in)
+    inline void nearby(Avionics* av, std::vector<std::string>& in)
     {
-        if(in.size() != 3)
+        if(in.size() != 1)
         {
-            std::cout << "Command expects 3 arguments: <airway name> <entry point> <exit point>\n";
+            std::cout << "Command expects 1 argument: <radius in nm>\n";
             return;
         }
 
-        std::vector<libnav::waypoint_entry_t> entry_wpts;
-        std::vector<libnav::waypoint_entry_t> exit_wpts;
+        double dist_nm = double(strutils::stof_with_strip(in[0]));
+        geo::point ac_pos = {av->ac_lat * geo::DEG_TO_RAD, av->ac_lon * geo::DEG_TO_RAD};
 
-        awy_filter_data_t filter_data = {in[0], av};
-        av->navaid_db_ptr->get_wpt_data(in[1], &entry_wpts, "", "", 
-            libnav::NavaidType::NAVAID, 
-            [](libnav::waypoint_t wpt, void* ref) -> bool {
-                awy_filter_data_t *data = reinterpret_cast<awy_filter_data_t*>(ref);
-                return data->ptr->awy_db->is_in_awy(data->s, wpt.get_awy_id());
-            }, &filter_data);
+        std::vector<libnav::airport_t> apts;
+        av->arpt_db_ptr->get_apts_in_range(ac_pos, dist_nm, &apts);
+        for(size_t i = 0; i < apts.size(); i++)
+        {
+            geo::point apt_pos = apts[i].data.pos;
+            std::cout << apts[i].icao << " APT " << 
+                apt_pos.get_gc_dist_nm(ac_pos) << "\n";
+        }
 
-        av->navaid_db_ptr->get_wpt_data(in[2], &exit_wpts, "", "", 
-            libnav::NavaidType::NAVAID, 
-            [](libnav::waypoint_t wpt, void* ref) -> bool {
-                awy_filter_data_t *data = reinterpret_cast<awy_filter_data_t*>(ref);
-                return data->ptr->awy_db->is_in_awy(data->s, wpt.get_awy_id());
-            }, &filter_data);
+        std::vector<libnav::waypoint_t> wpts;
+        av->navaid_db_ptr->get_wpts_in_range(ac_pos, dist_nm, &wpts, 
+            libnav::NavaidType::NAVAID);
+        libnav::sort_wpts_by_dist(&wpts, ac_pos);
+        for(size_t i = 0; i < wpts.size(); i++)
+        {
+            geo::point wpt_pos = wpts[i].data.pos;
+            std::cout << wpts[i].id << " " << libnav::navaid_to_str(wpts[i].data.type) 
+                << " " << wpt_pos.get_gc_dist_nm(ac_pos) << "\n";
+        }
+    }
 
-        
-        if(entry_wpts.size() && exit_wpts.size())
+    inline double get_pack_err_rad(geo::point p)
+    {
+        geo::point unpacked = geo::packed_point(p);
+        double lat_err = fabs(unpacked.lat_rad - p.lat_rad);
+        double lon_err = fabs(geo::normalize_dlon_rad(unpacked.lon_rad - p.lon_rad));
+        return lat_err > lon_err ? lat_err : lon_err;
+    }
+
+    inline void packchk(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size())
         {
-            libnav::waypoint_t entry_wpt = {in[1], entry_wpts[0]};
-            libnav::waypoint_t exit_wpt = {in[2], exit_wpts[0]};
-            std::vector<libnav::awy_point_t> tmp;
-            av->awy_db->get_ww_path(in[0], entry_wpt.get_awy_id(), exit_wpt.get_awy_id(), &tmp);
-            for(size_t i = 0; i < tmp.size(); i++)
+            std::cout << "Too many arguments provided\n";
+            return;
+        }
+
+        // Allow for rounding of the double math itself.
+        double tol_rad = geo::PACKED_MAX_ERR_RAD * (1 + 1e-6);
+        double max_err_rad = 0;
+        size_t n_checked = 0;
+        size_t n_failed = 0;
+
+        for(int i = -900; i <= 900; i++)
+        {
+            for(int j = -1800; j <= 1800; j++)
             {
-                std::cout << tmp[i].id << " " << tmp[i].alt_restr.lower 
-                    << " " << tmp[i].alt_restr.upper << "\n";
+                geo::point p = {double(i) * 0.1 * geo::DEG_TO_RAD + 1e-9 * double(j), 
+                    double(j) * 0.1 * geo::DEG_TO_RAD + 1e-9 * double(i)};
+                if(p.lat_rad > M_PI / 2 || p.lat_rad < -M_PI / 2)
+                    continue;
+                double err = get_pack_err_rad(p);
+                max_err_rad = std::max(max_err_rad, err);
+                n_failed += size_t(err > tol_rad);
+                n_checked++;
             }
         }
-        
+
+        for(auto& it: av->navaid_db_ptr->get_db())
+        {
+            for(auto& wpt: it.second)
+            {
+                double err = get_pack_err_rad(wpt.pos);
+                max_err_rad = std::max(max_err_rad, err);
+                n_failed += size_t(err > tol_rad);
+                n_checked++;
+            }
+        }
+
+        for(auto& it: av->arpt_db_ptr->get_arpt_db())
+        {
+            double err = get_pack_err_rad(it.second.pos);
+            max_err_rad = std::max(max_err_rad, err);
+            n_failed += size_t(err > tol_rad);
+            n_checked++;
+        }
+
+        std::cout << "Points checked: " << n_checked << "\n";
+        std::cout << "Max error(rad): " << max_err_rad << " bound(rad): " << 
+            geo::PACKED_MAX_ERR_RAD << "\n";
+        std::cout << "Max error(m): " << max_err_rad * geo::EARTH_RADIUS_NM * 
+            geo::NM_TO_M << "\n";
+        std::cout << "Out of bound: " << n_failed << "\n";
+        std::cout << "sizeof(point): " << sizeof(geo::point) << " sizeof(packed_point): " 
+            << sizeof(geo::packed_point) << " sizeof(stored_point): " << 
+            sizeof(geo::stored_point) << "\n";
+    }
+
+    inline void radnav(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 4)
+        {
+            std::cout << "Command expects 4 arguments: <altitude ft> <track deg> <step nm> <number of steps>\n";
+            return;
+        }
+
+        double alt_ft = double(strutils::stof_with_strip(in[0]));
+        double trk_rad = double(strutils::stof_with_strip(in[1])) * geo::DEG_TO_RAD;
+        double step_nm = double(strutils::stof_with_strip(in[2]));
+        int n_steps = strutils::stoi_with_strip(in[3]);
+
+        radnav_util::NavaidSelector sel(av->navaid_db_ptr);
+        geo::point3d ac_pos = {{av->ac_lat * geo::DEG_TO_RAD, 
+            av->ac_lon * geo::DEG_TO_RAD}, alt_ft};
+
+        // Reference set of all VOR/DME/NDB stations for brute force checks
+        std::vector<radnav_util::navaid_t> all_navs;
+        for(auto& it: av->navaid_db_ptr->get_db())
+        {
+            for(auto& wpt: it.second)
+            {
+                if(wpt.navaid != nullptr && wpt.navaid->max_recv != 0 &&
+                    (int(wpt.type) & int(radnav_util::NAVAID_SEL_TYPES)))
+                {
+                    all_navs.push_back({it.first, wpt, -1});
+                }
+            }
+        }
+
+        size_t n_mismatch = 0;
+        double sel_time_us = 0;
+        double brute_time_us = 0;
+        for(int i = 0; i < n_steps; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            sel.update(ac_pos);
+            auto mid = std::chrono::steady_clock::now();
+
+            size_t n_in_range = 0;
+            for(auto& nav: all_navs)
+            {
+                if(ac_pos.p.get_gc_dist_nm(nav.data.pos) <= nav.data.navaid->max_recv)
+                    n_in_range++;
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            sel_time_us += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                mid - start).count());
+            brute_time_us += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                end - mid).count());
+            n_mismatch += size_t(n_in_range != sel.get_n_in_range());
+
+            ac_pos.p = geo::get_pos_from_brng_dist(ac_pos.p, trk_rad, step_nm);
+        }
+
+        std::cout << "Stations: " << sel.get_n_stations() << " in range: " << 
+            sel.get_n_in_range() << "\n";
+        std::cout << "Mismatched steps: " << n_mismatch << "\n";
+        if(n_steps > 0)
+        {
+            std::cout << "Average update time(us): " << sel_time_us / n_steps << 
+                " brute force(us): " << brute_time_us / n_steps << "\n";
+        }
+
+        for(auto& nav: sel.get_best_navaids())
+        {
+            std::cout << nav.id << " " << libnav::navaid_to_str(nav.data.type) << 
+                " " << nav.qual << "\n";
+        }
+        for(auto& pair: sel.get_best_pairs())
+        {
+            std::cout << pair.n1->id << " " << pair.n2->id << " " << pair.qual << "\n";
+        }
+    }
+
+    inline void tune(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <frequency: MHz for VHF, kHz for NDB>\n";
+            return;
+        }
+
+        double freq = double(strutils::stof_with_strip(in[0]));
+        // earth_nav.dat stores VHF frequencies in 10s of kHz
+        if(freq < 200)
+            freq *= 100;
+        geo::point ac_pos = {av->ac_lat * geo::DEG_TO_RAD, av->ac_lon * geo::DEG_TO_RAD};
+
+        std::vector<libnav::waypoint_t> navs;
+        auto start = std::chrono::steady_clock::now();
+        av->navaid_db_ptr->get_navaids_by_freq(freq, ac_pos, &navs);
+        auto end = std::chrono::steady_clock::now();
+
+        for(size_t i = 0; i < navs.size(); i++)
+        {
+            geo::point nav_pos = navs[i].data.pos;
+            std::cout << navs[i].id << " " << libnav::navaid_to_str(navs[i].data.type) 
+                << " " << strutils::freq_to_str(navs[i].data.navaid->freq) << " " << 
+                nav_pos.get_gc_dist_nm(ac_pos) << "\n";
+        }
+
+        // Cross-check against a full scan
+        size_t n_expected = 0;
+        for(auto& it: av->navaid_db_ptr->get_db())
+        {
+            for(auto& wpt: it.second)
+            {
+                if(wpt.navaid != nullptr && std::round(wpt.navaid->freq) == std::round(freq) && 
+                    ac_pos.get_gc_dist_nm(wpt.pos) <= wpt.navaid->max_recv)
+                {
+                    n_expected++;
+                }
+            }
+        }
+        auto end_scan = std::chrono::steady_clock::now();
+
+        std::cout << "Found: " << navs.size() << " full scan: " << n_expected << "\n";
+        std::cout << "Lookup time(us): " << std::chrono::duration_cast<
+            std::chrono::microseconds>(end - start).count() << " full scan(us): " << 
+            std::chrono::duration_cast<std::chrono::microseconds>(end_scan - end).count() 
+            << "\n";
+    }
+
+    inline void aptinfo(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <airport icao>\n";
+            return;
+        }
+
+        libnav::airport_data_t apt_data;
+        if(!av->arpt_db_ptr->get_airport_data(in[0], &apt_data))
+        {
+            std::cout << "Not in data base\n";
+            return;
+        }
+
+        geo::point apt_pos = apt_data.pos;
+        std::cout << in[0] << " " << strutils::lat_to_str(apt_pos.lat_rad * geo::RAD_TO_DEG) 
+            << " " << strutils::lon_to_str(apt_pos.lon_rad * geo::RAD_TO_DEG) << " " << 
+            apt_data.elevation_ft << " " << apt_data.transition_alt_ft << " " << 
+            apt_data.transition_level << "\n";
+
+        libnav::runway_data rwys;
+        av->arpt_db_ptr->get_apt_rwys(in[0], &rwys);
+        for(auto& it: rwys)
+        {
+            libnav::runway_entry_t rnw;
+            av->arpt_db_ptr->get_rnw_data(in[0], it.first, &rnw);
+            std::cout << it.first << " " << rnw.get_impl_length_m() << " " << 
+                rnw.displ_threshold_m << "\n";
+        }
+    }
+
+    inline void aptbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 2)
+        {
+            std::cout << "Command expects 2 arguments: <number of threads> <number of rounds>\n";
+            return;
+        }
+
+        int n_threads = strutils::stoi_with_strip(in[0]);
+        int n_rounds = strutils::stoi_with_strip(in[1]);
+
+        std::vector<std::string> icaos;
+        for(auto& it: av->arpt_db_ptr->get_arpt_db())
+        {
+            icaos.push_back(it.first);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        std::vector<size_t> n_found(size_t(n_threads), 0);
+        for(int i = 0; i < n_threads; i++)
+        {
+            threads.push_back(std::thread([&av, &icaos, &n_found, n_rounds, i]() {
+                size_t n_curr = 0;
+                for(int j = 0; j < n_rounds; j++)
+                {
+                    for(auto& icao: icaos)
+                    {
+                        libnav::airport_data_t apt_data;
+                        libnav::runway_data rwys;
+                        n_curr += size_t(av->arpt_db_ptr->get_airport_data(icao, &apt_data));
+                        av->arpt_db_ptr->get_apt_rwys(icao, &rwys);
+                        for(auto& it: rwys)
+                        {
+                            libnav::runway_entry_t rnw;
+                            n_curr += size_t(av->arpt_db_ptr->get_rnw_data(
+                                icao, it.first, &rnw));
+                        }
+                    }
+                }
+                n_found[size_t(i)] = n_curr;
+            }));
+        }
+        for(auto& t: threads)
+        {
+            t.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        size_t n_total = 0;
+        for(auto n: n_found)
+        {
+            n_total += n;
+        }
+        std::cout << "Items found: " << n_total << "\n";
+        std::cout << "Time(ms): " << std::chrono::duration_cast<
+            std::chrono::milliseconds>(end - start).count() << "\n";
+    }
+
+    inline void phases(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size())
+        {
+            std::cout << "Too many arguments provided\n";
+            return;
+        }
+
+        typedef std::chrono::steady_clock clk_t;
+        std::mutex out_mutex;
+        std::vector<std::pair<std::string, double>> times;
+        clk_t::time_point start = clk_t::now();
+
+        auto make_cb = [&](std::string name) -> libnav::phase_cb_t {
+            return [&, name](libnav::DbErr err) {
+                double ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+                    clk_t::now() - start).count()) / 1000;
+                std::lock_guard<std::mutex> lock(out_mutex);
+                times.push_back({name + " " + std::to_string(int(err)), ms});
+            };
+        };
+
+        // Fresh data bases so that the load can be observed from the start
+        {
+            libnav::ArptDB arpt_db(av->apt_dat_path, av->custom_apt_path, 
+                av->custom_rnw_path);
+            libnav::NavaidDB navaid_db(av->fix_data_path, av->navaid_data_path);
+            libnav::AwyDB awy_db(av->awy_data_path);
+            libnav::HoldDB hold_db(av->hold_data_path);
+
+            arpt_db.get_arpt_phase().on_ready(make_cb("airports"));
+            arpt_db.get_rnw_phase().on_ready(make_cb("runways"));
+            arpt_db.get_cache_phase().on_ready(make_cb("airport cache"));
+            navaid_db.get_wpt_phase().on_ready(make_cb("fixes"));
+            navaid_db.get_navaid_phase().on_ready(make_cb("navaids"));
+            awy_db.get_load_phase().on_ready(make_cb("airways"));
+            hold_db.get_load_phase().on_ready(make_cb("holds"));
+
+            // Airports can be used before the rest is done
+            arpt_db.get_arpt_phase().wait();
+            libnav::airport_data_t apt_data;
+            size_t n_found = 0;
+            for(auto& it: arpt_db.get_arpt_db())
+            {
+                n_found += size_t(arpt_db.get_airport_data(it.first, &apt_data));
+            }
+            std::cout << "Airports found while loading: " << n_found << "\n";
+
+            arpt_db.get_err();
+            navaid_db.get_wpt_err();
+            navaid_db.get_navaid_err();
+            awy_db.get_err();
+            hold_db.get_err();
+        }
+
+        for(auto& it: times)
+        {
+            std::cout << it.first << " " << it.second << " ms\n";
+        }
+    }
+
+    inline void swapdb(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 2)
+        {
+            std::cout << "Command expects 2 arguments: <number of swaps> <number of reader threads>\n";
+            return;
+        }
+
+        int n_swaps = strutils::stoi_with_strip(in[0]);
+        int n_readers = strutils::stoi_with_strip(in[1]);
+
+        libnav::dataset_paths_t paths;
+        paths.apt_dat = av->apt_dat_path;
+        paths.custom_apt = av->custom_apt_path;
+        paths.custom_rnw = av->custom_rnw_path;
+        paths.fix_data = av->fix_data_path;
+        paths.navaid_data = av->navaid_data_path;
+        paths.awy_data = av->awy_data_path;
+        paths.hold_data = av->hold_data_path;
+
+        libnav::DatasetManager mgr;
+        std::cout << "Initial load: " << int(mgr.load(paths).get()) << "\n";
+
+        std::atomic<bool> stop{false};
+        std::atomic<size_t> n_queries{0};
+        std::atomic<size_t> n_failed{0};
+        std::vector<std::thread> readers;
+        for(int i = 0; i < n_readers; i++)
+        {
+            readers.push_back(std::thread([&mgr, &stop, &n_queries, &n_failed]() {
+                while(!stop.load())
+                {
+                    // Pin the generation for the whole query
+                    libnav::dataset_ptr_t ds = mgr.get_current();
+                    for(auto& it: ds->arpt_db->get_arpt_db())
+                    {
+                        libnav::airport_data_t apt_data;
+                        n_failed += size_t(!ds->arpt_db->get_airport_data(it.first, 
+                            &apt_data));
+                        n_queries++;
+                    }
+                }
+            }));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < n_swaps; i++)
+        {
+            libnav::DbErr err = mgr.load(paths).get();
+            if(err != libnav::DbErr::SUCCESS)
+            {
+                std::cout << "Load failed: " << int(err) << "\n";
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        stop.store(true);
+        for(auto& it: readers)
+        {
+            it.join();
+        }
+
+        std::cout << "Generation: " << mgr.get_generation() << "\n";
+        std::cout << "Queries: " << n_queries.load() << " failed: " << n_failed.load() << "\n";
+        std::cout << "Average swap time(ms): " << (n_swaps > 0 ? 
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 
+            n_swaps : 0) << "\n";
+    }
+
+    inline void cancelload(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <delay before cancelling(ms)>\n";
+            return;
+        }
+
+        int delay_ms = strutils::stoi_with_strip(in[0]);
+
+        // Use a temporary copy of the airport cache so that a cancelled write
+        // doesn't touch the files used by the rest of the session.
+        std::string tmp_apt = av->custom_apt_path + ".cancel";
+        std::string tmp_rnw = av->custom_rnw_path + ".cancel";
+        std::remove(tmp_apt.c_str());
+        std::remove(tmp_rnw.c_str());
+
+        typedef std::chrono::steady_clock clk_t;
+        std::unique_ptr<libnav::ArptDB> arpt_db(new libnav::ArptDB(av->apt_dat_path,
+            tmp_apt, tmp_rnw));
+        std::unique_ptr<libnav::NavaidDB> navaid_db(new libnav::NavaidDB(
+            av->fix_data_path, av->navaid_data_path));
+        std::unique_ptr<libnav::AwyDB> awy_db(new libnav::AwyDB(av->awy_data_path));
+        std::unique_ptr<libnav::HoldDB> hold_db(new libnav::HoldDB(av->hold_data_path));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+
+        clk_t::time_point start = clk_t::now();
+        arpt_db->cancel_load();
+        navaid_db->cancel_load();
+        awy_db->cancel_load();
+        hold_db->cancel_load();
+
+        std::cout << "airports " << int(arpt_db->get_arpt_phase().wait()) << "\n";
+        std::cout << "runways " << int(arpt_db->get_rnw_phase().wait()) << "\n";
+        std::cout << "airport cache " << int(arpt_db->get_cache_phase().wait()) << "\n";
+        std::cout << "fixes " << int(navaid_db->get_wpt_phase().wait()) << "\n";
+        std::cout << "navaids " << int(navaid_db->get_navaid_phase().wait()) << "\n";
+        std::cout << "airways " << int(awy_db->get_load_phase().wait()) << "\n";
+        std::cout << "holds " << int(hold_db->get_load_phase().wait()) << "\n";
+
+        arpt_db.reset();
+        navaid_db.reset();
+        awy_db.reset();
+        hold_db.reset();
+        double ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            clk_t::now() - start).count()) / 1000;
+        std::cout << "Cancelled and destroyed in " << ms << " ms\n";
+
+        std::remove(tmp_apt.c_str());
+        std::remove(tmp_rnw.c_str());
+    }
+
+    inline void aptasync(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 2)
+        {
+            std::cout << "Command expects 2 arguments: <airport icao> <number of requests>\n";
+            return;
+        }
+
+        int n_req = strutils::stoi_with_strip(in[1]);
+
+        typedef std::chrono::steady_clock clk_t;
+        clk_t::time_point start = clk_t::now();
+        std::atomic<int> n_cb{0};
+        std::vector<libnav::airport_future_t> futures;
+        for(int i = 0; i < n_req; i++)
+        {
+            futures.push_back(libnav::Airport::load_async(in[0], av->arpt_db_ptr,
+                av->navaid_db_ptr, av->cifp_dir_path, ".dat", false, libnav::APPR_PREF,
+                [&n_cb](libnav::airport_ptr_t apt) { n_cb += int(apt != nullptr); }));
+        }
+        double submit_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            clk_t::now() - start).count()) / 1000;
+
+        size_t n_shared = 0;
+        libnav::airport_ptr_t first = nullptr;
+        for(auto& it: futures)
+        {
+            libnav::airport_ptr_t apt = it.get();
+            if(first == nullptr)
+            {
+                first = apt;
+            }
+            n_shared += size_t(apt == first);
+        }
+        double load_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            clk_t::now() - start).count()) / 1000;
+
+        // Callbacks run after the future is set
+        while(n_cb.load() != n_req)
+        {
+            std::this_thread::yield();
+        }
+
+        std::cout << "Submitted in " << submit_ms << " ms, loaded in " << load_ms << " ms\n";
+        std::cout << "Requests sharing the first load: " << n_shared << "/" << n_req << "\n";
+        if(first != nullptr)
+        {
+            std::cout << "Error code: " << int(first->err_code) << " runways: " <<
+                first->get_rwys().size() << "\n";
+        }
+    }
+
+    inline void aptcache(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() < 2)
+        {
+            std::cout << "Command expects at least 2 arguments: <memory budget(kB)> <airport icao> ...\n";
+            return;
+        }
+
+        size_t budget = size_t(strutils::stoi_with_strip(in[0])) * 1024;
+        libnav::AirportCache cache(av->arpt_db_ptr, av->navaid_db_ptr, av->cifp_dir_path,
+            budget);
+
+        typedef std::chrono::steady_clock clk_t;
+        for(int pass = 0; pass < 2; pass++)
+        {
+            clk_t::time_point start = clk_t::now();
+            for(size_t i = 1; i < in.size(); i++)
+            {
+                libnav::airport_cptr_t apt = cache.get(in[i]);
+                if(pass == 0 && apt != nullptr)
+                {
+                    std::cout << in[i] << " error code: " << int(apt->err_code) <<
+                        " memory(B): " << apt->get_mem_usage() << " sids: " <<
+                        apt->get_all_sids().size() << "\n";
+                }
+            }
+            double ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+                clk_t::now() - start).count()) / 1000;
+            std::cout << "Pass " << pass + 1 << ": " << ms << " ms\n";
+        }
+
+        std::cout << "Airports cached: " << cache.get_n_airports() << " memory(B): " <<
+            cache.get_mem_usage() << " hits: " << cache.get_n_hits() << " misses: " <<
+            cache.get_n_misses() << "\n";
+    }
+
+    inline void cifpbuild(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <archive path>\n";
+            return;
+        }
+
+        size_t n_written = 0;
+        libnav::DbErr err = libnav::CifpArchive::compile(in[0], av->arpt_db_ptr,
+            av->cifp_dir_path, ".dat", av->navaid_db_ptr->get_wpt_cycle(), &n_written);
+        std::cout << "Error code: " << int(err) << " airports: " << n_written << "\n";
+    }
+
+    inline std::string get_proc_summary(const libnav::Airport& apt)
+    {
+        std::stringstream s;
+        s << int(apt.err_code);
+        for(auto& rwy: apt.get_rwys())
+        {
+            s << " " << rwy;
+        }
+        libnav::str_umap_t procs[] = {apt.get_all_sids(), apt.get_all_stars(),
+            apt.get_all_appch()};
+        for(int i = 0; i < 3; i++)
+        {
+            std::map<std::string, libnav::str_set_t> sorted(procs[i].begin(),
+                procs[i].end());
+            for(auto& proc: sorted)
+            {
+                for(auto& trans: proc.second)
+                {
+                    libnav::arinc_leg_seq_t legs = i == 0 ? apt.get_sid(proc.first, trans) :
+                        (i == 1 ? apt.get_star(proc.first, trans) :
+                        apt.get_appch(proc.first, trans));
+                    s << "\n" << proc.first << " " << trans;
+                    for(auto& leg: legs)
+                    {
+                        s << " " << leg.leg_type << ":" << leg.main_fix.id << ":" <<
+                            leg.recd_navaid.id << ":" << leg.alt1_ft;
+                    }
+                }
+            }
+        }
+        return s.str();
+    }
+
+    inline void cifpbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <archive path>\n";
+            return;
+        }
+
+        typedef std::chrono::steady_clock clk_t;
+        clk_t::time_point start = clk_t::now();
+        std::shared_ptr<const libnav::CifpArchive> archive =
+            std::make_shared<libnav::CifpArchive>(in[0]);
+        double open_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            clk_t::now() - start).count()) / 1000;
+        std::cout << "Archive error code: " << int(archive->get_err()) << " airports: " <<
+            archive->get_n_airports() << " stale: " <<
+            archive->is_stale(av->navaid_db_ptr->get_wpt_cycle()) << " opened in " <<
+            open_ms << " ms\n";
+
+        double text_ms = 0;
+        double archive_ms = 0;
+        size_t n_apts = 0;
+        size_t n_mismatch = 0;
+        for(auto& it: av->arpt_db_ptr->get_arpt_db())
+        {
+            const char* records;
+            size_t records_sz;
+            if(!archive->get_airport(it.first, &records, &records_sz))
+            {
+                continue;
+            }
+
+            start = clk_t::now();
+            libnav::Airport text_apt(it.first, av->arpt_db_ptr, av->navaid_db_ptr,
+                av->cifp_dir_path);
+            clk_t::time_point mid = clk_t::now();
+            libnav::Airport archive_apt(it.first, av->arpt_db_ptr, av->navaid_db_ptr,
+                archive, av->cifp_dir_path);
+            clk_t::time_point end = clk_t::now();
+
+            text_ms += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                mid - start).count()) / 1000;
+            archive_ms += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                end - mid).count()) / 1000;
+            n_apts++;
+            if(get_proc_summary(text_apt) != get_proc_summary(archive_apt))
+            {
+                std::cout << "Mismatch: " << it.first << "\n";
+                n_mismatch++;
+            }
+        }
+
+        std::cout << "Airports: " << n_apts << " mismatches: " << n_mismatch << "\n";
+        std::cout << "Text: " << text_ms << " ms archive: " << archive_ms << " ms\n";
+    }
+
+    inline bool arinc_fix_eq(libnav::arinc_fix_entry_t& a, libnav::arinc_fix_entry_t& b)
+    {
+        return a.fix_ident == b.fix_ident && a.country_code == b.country_code &&
+            a.db_section == b.db_section && a.db_subsection == b.db_subsection;
+    }
+
+    inline bool arinc_str_eq(libnav::arinc_str_t& a, libnav::arinc_str_t& b)
+    {
+        return a.rt_type == b.rt_type && arinc_fix_eq(a.main_fix, b.main_fix) &&
+            a.wpt_desc == b.wpt_desc && a.turn_dir == b.turn_dir && a.rnp == b.rnp &&
+            a.leg_type == b.leg_type && a.tdv == b.tdv &&
+            arinc_fix_eq(a.recd_navaid, b.recd_navaid) && a.arc_radius == b.arc_radius &&
+            a.theta == b.theta && a.rho == b.rho && a.outbd_mag_crs == b.outbd_mag_crs &&
+            a.outbd_dist_time == b.outbd_dist_time && a.alt_desc == b.alt_desc &&
+            a.alt1 == b.alt1 && a.alt2 == b.alt2 && a.trans_alt == b.trans_alt &&
+            a.speed_desc == b.speed_desc && a.spd_lim == b.spd_lim &&
+            a.vert_angle == b.vert_angle && a.vert_scale == b.vert_scale &&
+            arinc_fix_eq(a.center_fix, b.center_fix) && a.multi_cod == b.multi_cod &&
+            a.gnss_ind == b.gnss_ind && a.rt_qual1 == b.rt_qual1 &&
+            a.rt_qual2 == b.rt_qual2;
+    }
+
+    inline void arincbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of passes>\n";
+            return;
+        }
+
+        std::vector<std::string> lines;
+        for(auto& it: av->arpt_db_ptr->get_arpt_db())
+        {
+            std::ifstream file(av->cifp_dir_path + "/" + it.first + ".dat");
+            std::string line;
+            while(std::getline(file, line))
+            {
+                libnav::ProcType tp = libnav::str2proc_type(line);
+                if(tp == libnav::ProcType::SID || tp == libnav::ProcType::STAR ||
+                    tp == libnav::ProcType::APPROACH)
+                {
+                    lines.push_back(line);
+                }
+            }
+        }
+
+        size_t n_mismatch = 0;
+        strutils::str_span_t cols[libnav::N_ARINC_FLT_PROC_COL];
+        for(auto& line: lines)
+        {
+            std::vector<std::string> s_split = strutils::str_split(line,
+                libnav::ARINC_FIELD_SEP);
+            size_t n_cols = strutils::str_split_spans(line.c_str(), line.length(),
+                libnav::ARINC_FIELD_SEP, cols, libnav::N_ARINC_FLT_PROC_COL);
+            if(n_cols != s_split.size())
+            {
+                n_mismatch++;
+                continue;
+            }
+            if(n_cols != libnav::N_ARINC_FLT_PROC_COL)
+            {
+                continue;
+            }
+
+            libnav::arinc_str_t old_str(s_split);
+            libnav::arinc_str_t new_str(line.c_str(), cols);
+            if(!arinc_str_eq(old_str, new_str) ||
+                new_str.proc_name != strutils::strip(s_split[2], ' ') ||
+                new_str.trans_name != strutils::strip(s_split[3], ' '))
+            {
+                std::cout << "Mismatch: " << line << "\n";
+                n_mismatch++;
+            }
+        }
+        std::cout << "Lines: " << lines.size() << " mismatches: " << n_mismatch << "\n";
+
+        int n_passes = std::max(1, atoi(in[0].c_str()));
+        typedef std::chrono::steady_clock clk_t;
+        size_t sink = 0;
+        clk_t::time_point start = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& line: lines)
+            {
+                std::vector<std::string> s_split = strutils::str_split(line,
+                    libnav::ARINC_FIELD_SEP);
+                if(s_split.size() == libnav::N_ARINC_FLT_PROC_COL)
+                {
+                    libnav::arinc_str_t tmp(s_split);
+                    sink += tmp.leg_type.size();
+                }
+            }
+        }
+        clk_t::time_point mid = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& line: lines)
+            {
+                size_t n_cols = strutils::str_split_spans(line.c_str(),
+                    line.length(), libnav::ARINC_FIELD_SEP, cols,
+                    libnav::N_ARINC_FLT_PROC_COL);
+                if(n_cols == libnav::N_ARINC_FLT_PROC_COL)
+                {
+                    libnav::arinc_str_t tmp(line.c_str(), cols);
+                    sink += tmp.leg_type.size();
+                }
+            }
+        }
+        clk_t::time_point end = clk_t::now();
+
+        double old_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            mid - start).count()) / 1000;
+        double new_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            end - mid).count()) / 1000;
+        std::cout << "Vector decoder: " << old_ms << " ms span decoder: " << new_ms <<
+            " ms (" << sink << ")\n";
+    }
+
+    inline void numbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of passes>\n";
+            return;
+        }
+
+        // Numeric columns of the earth*.dat files
+        std::vector<std::string> words;
+        std::string paths[] = {av->fix_data_path, av->navaid_data_path,
+            av->hold_data_path};
+        for(auto& path: paths)
+        {
+            std::ifstream file(path);
+            std::string line;
+            while(std::getline(file, line))
+            {
+                for(auto& word: strutils::str_split(line))
+                {
+                    char* end;
+                    std::strtod(word.c_str(), &end);
+                    if(word.size() && *end == 0 && strutils::is_numeric(word))
+                    {
+                        words.push_back(word);
+                    }
+                }
+            }
+        }
+
+        size_t n_mismatch = 0;
+        for(auto& word: words)
+        {
+            double val = 0;
+            if(!strutils::str_to_double(word, &val) || val != atof(word.c_str()))
+            {
+                std::cout << "Mismatch: " << word << "\n";
+                n_mismatch++;
+            }
+        }
+        std::cout << "Numbers: " << words.size() << " mismatches: " << n_mismatch << "\n";
+
+        int n_passes = std::max(1, atoi(in[0].c_str()));
+        typedef std::chrono::steady_clock clk_t;
+        double sink = 0;
+        clk_t::time_point start = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& word: words)
+            {
+                std::string stripped = strutils::strip(word, ' ');
+                sink += atof(stripped.c_str());
+            }
+        }
+        clk_t::time_point t1 = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& word: words)
+            {
+                std::stringstream ss(word);
+                double val = 0;
+                ss >> val;
+                sink += val;
+            }
+        }
+        clk_t::time_point t2 = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& word: words)
+            {
+                double val = 0;
+                strutils::str_to_double(word, &val);
+                sink += val;
+            }
+        }
+        clk_t::time_point t3 = clk_t::now();
+
+        auto to_ms = [](clk_t::duration d) -> double {
+            return double(std::chrono::duration_cast<std::chrono::microseconds>(
+                d).count()) / 1000;
+        };
+        std::cout << "strip+atof: " << to_ms(t1 - start) << " ms stringstream: " <<
+            to_ms(t2 - t1) << " ms str_to_double: " << to_ms(t3 - t2) << " ms (" <<
+            sink << ")\n";
+    }
+
+    // The stringstream based splitter that str_split used to be. Kept for comparison.
+    inline std::vector<std::string> stream_split(std::string& in, char sep, int n_split)
+    {
+        std::stringstream s(in);
+        std::string tmp;
+        std::vector<std::string> out;
+
+        while(n_split && std::getline(s, tmp, sep))
+        {
+            if(tmp != "")
+            {
+                n_split--;
+                out.push_back(strutils::strip(tmp, '\r'));
+            }
+        }
+        if(!n_split)
+        {
+            std::getline(s, tmp);
+            if(tmp.length())
+                out.push_back(strutils::strip(tmp, '\r'));
+        }
+        return out;
+    }
+
+    inline void splitbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of passes>\n";
+            return;
+        }
+
+        // Space separated earth*.dat lines and comma separated CIFP lines
+        std::vector<std::pair<std::string, char>> lines;
+        std::string paths[] = {av->fix_data_path, av->navaid_data_path,
+            av->awy_data_path, av->hold_data_path};
+        for(auto& path: paths)
+        {
+            std::ifstream file(path);
+            std::string line;
+            while(std::getline(file, line))
+            {
+                lines.push_back(std::make_pair(line, ' '));
+            }
+        }
+        for(auto& it: av->arpt_db_ptr->get_arpt_db())
+        {
+            std::ifstream file(av->cifp_dir_path + "/" + it.first + ".dat");
+            std::string line;
+            while(std::getline(file, line))
+            {
+                lines.push_back(std::make_pair(line, libnav::ARINC_FIELD_SEP));
+            }
+        }
+
+        size_t n_mismatch = 0;
+        for(auto& line: lines)
+        {
+            if(stream_split(line.first, line.second, INT32_MAX) !=
+                strutils::str_split(line.first, line.second))
+            {
+                n_mismatch++;
+            }
+        }
+        std::cout << "Lines: " << lines.size() << " mismatches: " << n_mismatch << "\n";
+
+        int n_passes = std::max(1, atoi(in[0].c_str()));
+        typedef std::chrono::steady_clock clk_t;
+        size_t sink = 0;
+        strutils::str_span_t cols[64];
+        clk_t::time_point start = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& line: lines)
+            {
+                sink += stream_split(line.first, line.second, INT32_MAX).size();
+            }
+        }
+        clk_t::time_point t1 = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& line: lines)
+            {
+                sink += strutils::str_split(line.first, line.second).size();
+            }
+        }
+        clk_t::time_point t2 = clk_t::now();
+        for(int i = 0; i < n_passes; i++)
+        {
+            for(auto& line: lines)
+            {
+                sink += strutils::str_split_spans(line.first.c_str(), line.first.size(),
+                    line.second, cols, 64);
+            }
+        }
+        clk_t::time_point t3 = clk_t::now();
+
+        auto to_ms = [](clk_t::duration d) -> double {
+            return double(std::chrono::duration_cast<std::chrono::microseconds>(
+                d).count()) / 1000;
+        };
+        std::cout << "stringstream: " << to_ms(t1 - start) << " ms str_split: " <<
+            to_ms(t2 - t1) << " ms str_split_spans: " << to_ms(t3 - t2) << " ms (" <<
+            sink << ")\n";
+    }
+
+    inline void fmtbench(Avionics* av, std::vector<std::string>& in)
+    {
+        (void)av;
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of values>\n";
+            return;
+        }
+
+        int n_vals = std::max(1, atoi(in[0].c_str()));
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> lat_dist(-90, 90);
+        std::uniform_real_distribution<double> lon_dist(-180, 180);
+        std::uniform_real_distribution<double> freq_dist(190, 11800);
+        std::uniform_real_distribution<double> var_dist(-40, 40);
+        std::vector<double> lats, lons, freqs, vars;
+        for(int i = 0; i < n_vals; i++)
+        {
+            lats.push_back(lat_dist(rng));
+            lons.push_back(lon_dist(rng));
+            freqs.push_back(std::round(freq_dist(rng)));
+            vars.push_back(var_dist(rng));
+        }
+
+        char buf[strutils::N_FMT_BUF_SZ];
+        size_t n_mismatch = 0;
+        for(int i = 0; i < n_vals; i++)
+        {
+            strutils::lat_to_buf(lats[size_t(i)], buf, sizeof(buf));
+            n_mismatch += strutils::lat_to_str(lats[size_t(i)]) != buf;
+            strutils::lon_to_buf(lons[size_t(i)], buf, sizeof(buf));
+            n_mismatch += strutils::lon_to_str(lons[size_t(i)]) != buf;
+            strutils::freq_to_buf(freqs[size_t(i)], buf, sizeof(buf));
+            n_mismatch += strutils::freq_to_str(freqs[size_t(i)]) != buf;
+            strutils::mag_var_to_buf(vars[size_t(i)], buf, sizeof(buf));
+            n_mismatch += strutils::mag_var_to_str(vars[size_t(i)]) != buf;
+            strutils::double_to_buf(lats[size_t(i)], 4, buf, sizeof(buf));
+            n_mismatch += strutils::double_to_str(lats[size_t(i)], 4) != buf;
+        }
+        std::cout << "Values: " << n_vals << " mismatches: " << n_mismatch << "\n";
+
+        typedef std::chrono::steady_clock clk_t;
+        size_t sink = 0;
+        clk_t::time_point start = clk_t::now();
+        for(int i = 0; i < n_vals; i++)
+        {
+            sink += strutils::lat_to_str(lats[size_t(i)]).size();
+            sink += strutils::lon_to_str(lons[size_t(i)]).size();
+            sink += strutils::freq_to_str(freqs[size_t(i)]).size();
+            sink += strutils::mag_var_to_str(vars[size_t(i)]).size();
+            sink += strutils::double_to_str(lats[size_t(i)], 4).size();
+        }
+        clk_t::time_point mid = clk_t::now();
+        for(int i = 0; i < n_vals; i++)
+        {
+            sink += strutils::lat_to_buf(lats[size_t(i)], buf, sizeof(buf));
+            sink += strutils::lon_to_buf(lons[size_t(i)], buf, sizeof(buf));
+            sink += strutils::freq_to_buf(freqs[size_t(i)], buf, sizeof(buf));
+            sink += strutils::mag_var_to_buf(vars[size_t(i)], buf, sizeof(buf));
+            sink += strutils::double_to_buf(lats[size_t(i)], 4, buf, sizeof(buf));
+        }
+        clk_t::time_point end = clk_t::now();
+
+        double str_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            mid - start).count()) / 1000;
+        double buf_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            end - mid).count()) / 1000;
+        std::cout << "std::string: " << str_ms << " ms buffer: " << buf_ms << " ms (" <<
+            sink << ")\n";
+    }
+
+    // Returns airway id of the first fix with this name that is on an airway
+    inline std::string get_awy_fix_uid(Avionics* av, std::string& name)
+    {
+        std::vector<libnav::waypoint_entry_t> wpts;
+        av->navaid_db_ptr->get_wpt_data(name, &wpts);
+        for(auto& it: wpts)
+        {
+            libnav::waypoint_t wpt = {name, it};
+            std::string uid = wpt.get_awy_id();
+            if(av->get_awy_router()->has_fix(uid))
+            {
+                return uid;
+            }
+        }
+        return "";
+    }
+
+    // Forms a route string like "A J1 B J2 C"
+    inline std::string awy_route_to_str(std::vector<libnav::awy_route_leg_t>& route)
+    {
+        std::string out;
+        for(size_t i = 0; i < route.size(); i++)
+        {
+            std::string id = route[i].point.id.substr(0, 
+                route[i].point.id.find(libnav::AUX_ID_SEP));
+            if(i == 0)
+            {
+                out = id;
+            }
+            else if(i + 1 == route.size() || route[i + 1].awy != route[i].awy)
+            {
+                out += " " + route[i].awy + " " + id;
+            }
+        }
+        return out;
+    }
+
+    inline void print_awy_route(std::vector<libnav::awy_route_leg_t>& route)
+    {
+        double dist_nm = 0;
+        for(size_t i = 0; i < route.size(); i++)
+        {
+            dist_nm += route[i].dist_nm;
+        }
+        std::cout << awy_route_to_str(route) << "\n" << route.size() << " fixes " << 
+            dist_nm << " nm\n";
+    }
+
+    inline void awyroute(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 2 && in.size() != 3)
+        {
+            std::cout << "Command expects 2 or 3 arguments: <start fix> <end fix> <flight level>\n";
+            return;
+        }
+
+        std::string start = get_awy_fix_uid(av, in[0]);
+        std::string end = get_awy_fix_uid(av, in[1]);
+        if(start == "" || end == "")
+        {
+            std::cout << "Fix isn't on any airway\n";
+            return;
+        }
+
+        libnav::awy_route_opts_t opts;
+        if(in.size() == 3)
+        {
+            opts.fl = uint32_t(strutils::stoi_with_strip(in[2]));
+        }
+
+        std::vector<libnav::awy_route_leg_t> route;
+        auto t_start = std::chrono::steady_clock::now();
+        av->get_awy_router()->get_route(start, end, &route, opts);
+        double route_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t_start).count()) / 1000;
+
+        if(route.size() == 0)
+        {
+            std::cout << "No route\n";
+            return;
+        }
+        print_awy_route(route);
+        std::cout << "Found in " << route_ms << " ms\n";
+    }
+
+    inline void routebench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 2)
+        {
+            std::cout << "Command expects 2 arguments: <number of routes> <max distance nm>\n";
+            return;
+        }
+
+        int n_routes = strutils::stoi_with_strip(in[0]);
+        double max_dist_nm = double(strutils::stof_with_strip(in[1]));
+        std::shared_ptr<libnav::AwyRouter> router = av->get_awy_router();
+        if(router->get_n_nodes() == 0)
+        {
+            return;
+        }
+
+        // Pick random pairs that are close enough to be connected by airways
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<size_t> dist(0, router->get_n_nodes() - 1);
+        std::vector<std::pair<std::string, std::string>> pairs;
+        while(int(pairs.size()) < n_routes)
+        {
+            uint32_t s = uint32_t(dist(gen));
+            uint32_t e = uint32_t(dist(gen));
+            const libnav::waypoint_entry_t* w1 = av->awy_db->get_fix_wpt(s);
+            const libnav::waypoint_entry_t* w2 = av->awy_db->get_fix_wpt(e);
+            if(w1 == nullptr || w2 == nullptr)
+            {
+                continue;
+            }
+            geo::point p1 = w1->pos;
+            if(p1.get_gc_dist_nm(w2->pos) <= max_dist_nm)
+            {
+                pairs.push_back({router->get_node_uid(s), router->get_node_uid(e)});
+            }
+        }
+
+        size_t n_found = 0;
+        size_t n_legs = 0;
+        std::vector<libnav::awy_route_leg_t> route;
+        auto start = std::chrono::steady_clock::now();
+        for(auto& it: pairs)
+        {
+            route.clear();
+            n_legs += router->get_route(it.first, it.second, &route);
+            n_found += size_t(route.size() != 0);
+        }
+        double total_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count()) / 1000;
+
+        std::cout << "Routes found: " << n_found << "/" << pairs.size() << " legs: " << 
+            n_legs << "\n";
+        if(pairs.size())
+        {
+            std::cout << "Total: " << total_ms << " ms per route: " << 
+                total_ms / double(pairs.size()) << " ms\n";
+        }
+    }
+
+    inline void get_path(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 3)
+        {
+            std::cout << "Command expects 3 arguments: <airway name> <entry point> <exit point>\n";
+            return;
+        }
+
+        std::vector<libnav::waypoint_entry_t> entry_wpts;
+        std::vector<libnav::waypoint_entry_t> exit_wpts;
+
+        awy_filter_data_t filter_data = {in[0], av};
+        av->navaid_db_ptr->get_wpt_data(in[1], &entry_wpts, "", "", 
+            libnav::NavaidType::NAVAID, 
+            [](libnav::waypoint_t wpt, void* ref) -> bool {
+                awy_filter_data_t *data = reinterpret_cast<awy_filter_data_t*>(ref);
+                return data->ptr->awy_db->is_in_awy(data->s, wpt.get_awy_id());
+            }, &filter_data);
+
+        av->navaid_db_ptr->get_wpt_data(in[2], &exit_wpts, "", "", 
+            libnav::NavaidType::NAVAID, 
+            [](libnav::waypoint_t wpt, void* ref) -> bool {
+                awy_filter_data_t *data = reinterpret_cast<awy_filter_data_t*>(ref);
+                return data->ptr->awy_db->is_in_awy(data->s, wpt.get_awy_id());
+            }, &filter_data);
+
+        
+        if(entry_wpts.size() && exit_wpts.size())
+        {
+            libnav::waypoint_t entry_wpt = {in[1], entry_wpts[0]};
+            libnav::waypoint_t exit_wpt = {in[2], exit_wpts[0]};
+            std::vector<libnav::awy_point_t> tmp;
+            av->awy_db->get_ww_path(in[0], entry_wpt.get_awy_id(), exit_wpt.get_awy_id(), &tmp);
+            for(size_t i = 0; i < tmp.size(); i++)
+            {
+                std::cout << tmp[i].id << " " << tmp[i].alt_restr.lower 
+                    << " " << tmp[i].alt_restr.upper << "\n";
+            }
+        }
+        
+    }
+
+    inline void crossawy(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <airway name>\n";
+            return;
+        }
+
+        const libnav::awy_isect_t* isect = av->awy_db->get_isect(in[0]);
+        if(isect == nullptr)
+        {
+            std::cout << "Airway doesn't cross any other airway\n";
+            return;
+        }
+        std::map<std::string, std::vector<std::string>> sorted(isect->begin(), isect->end());
+        for(auto& it: sorted)
+        {
+            std::cout << it.first << ":";
+            for(auto& fix: it.second)
+            {
+                std::cout << " " << fix;
+            }
+            std::cout << "\n";
+        }
+    }
+
+    inline void aabench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of queries>\n";
+            return;
+        }
+
+        int n_queries = strutils::stoi_with_strip(in[0]);
+        const libnav::awy_db_t& db = av->awy_db->get_db();
+
+        // Random airway, fix on it and one of the airways that cross it
+        std::vector<std::string> awys;
+        for(auto& it: db)
+        {
+            if(av->awy_db->get_isect(it.first) != nullptr)
+            {
+                awys.push_back(it.first);
+            }
+        }
+        if(awys.size() == 0)
+        {
+            return;
+        }
+        std::mt19937 gen(1);
+        std::vector<std::vector<std::string>> queries;
+        for(int i = 0; i < n_queries; i++)
+        {
+            std::string awy = awys[gen() % awys.size()];
+            const libnav::graph_t& graph = db.at(awy);
+            auto it_fix = std::next(graph.begin(), long(gen() % graph.size()));
+            const libnav::awy_isect_t* isect = av->awy_db->get_isect(awy);
+            auto it_awy = std::next(isect->begin(), long(gen() % isect->size()));
+            queries.push_back({awy, it_fix->first, it_awy->first});
+        }
+
+        typedef std::chrono::steady_clock clk_t;
+        size_t n_mismatch = 0;
+        size_t n_found = 0;
+        double cb_ms = 0;
+        double isect_ms = 0;
+        std::vector<libnav::awy_point_t> p1, p2;
+        for(auto& q: queries)
+        {
+            p1.clear();
+            p2.clear();
+            libnav::awy_to_awy_data_t awy_data = {q[2], av->awy_db.get()};
+            clk_t::time_point start = clk_t::now();
+            av->awy_db->get_path(q[0], q[1], &p1, libnav::awy_awy_to_awy_func, &awy_data);
+            clk_t::time_point mid = clk_t::now();
+            av->awy_db->get_aa_path(q[0], q[1], q[2], &p2);
+            clk_t::time_point end = clk_t::now();
+
+            cb_ms += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                mid - start).count()) / 1000;
+            isect_ms += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                end - mid).count()) / 1000;
+            n_found += size_t(p2.size() != 0);
+
+            bool is_eq = p1.size() == p2.size();
+            for(size_t i = 0; is_eq && i < p1.size(); i++)
+            {
+                is_eq = p1[i].id == p2[i].id && 
+                    p1[i].alt_restr.lower == p2[i].alt_restr.lower &&
+                    p1[i].alt_restr.upper == p2[i].alt_restr.upper;
+            }
+            n_mismatch += size_t(!is_eq);
+        }
+
+        std::cout << "Paths found: " << n_found << "/" << queries.size() << 
+            " mismatches: " << n_mismatch << "\n";
+        std::cout << "is_in_awy callback: " << cb_ms << " ms intersection index: " << 
+            isect_ms << " ms\n";
+    }
+
+    inline void fixawys(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <fix name>\n";
+            return;
+        }
+
+        std::vector<libnav::waypoint_entry_t> wpts;
+        av->navaid_db_ptr->get_wpt_data(in[0], &wpts);
+        for(auto& it: wpts)
+        {
+            libnav::waypoint_t wpt = {in[0], it};
+            uint32_t idx = av->awy_db->get_fix_idx(wpt.get_awy_id());
+            if(idx == libnav::AWY_IDX_NONE)
+            {
+                continue;
+            }
+
+            std::cout << wpt.get_awy_id() << ":";
+            for(auto awy: av->awy_db->get_fix_awys(idx))
+            {
+                std::cout << " " << av->awy_db->get_awy_name(awy);
+            }
+            std::cout << "\n";
+            for(auto& e: av->awy_db->get_fix_edges(idx))
+            {
+                std::cout << "    " << av->awy_db->get_awy_name(e.awy) << " -> " << 
+                    av->awy_db->get_fix_uid(e.to) << " " << e.alt_restr.lower << " " << 
+                    e.alt_restr.upper << "\n";
+            }
+        }
+    }
+
+    inline void fixawybench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of queries>\n";
+            return;
+        }
+
+        int n_queries = strutils::stoi_with_strip(in[0]);
+        size_t n_fixes = av->awy_db->get_n_fixes();
+        if(n_fixes == 0)
+        {
+            return;
+        }
+        std::mt19937 gen(1);
+        std::vector<std::string> uids;
+        for(int i = 0; i < n_queries; i++)
+        {
+            uids.push_back(av->awy_db->get_fix_uid(uint32_t(gen() % n_fixes)));
+        }
+
+        typedef std::chrono::steady_clock clk_t;
+        size_t n_mismatch = 0;
+        size_t n_awys = 0;
+        double scan_ms = 0;
+        double index_ms = 0;
+        std::vector<std::string> scan_out;
+        for(auto& uid: uids)
+        {
+            scan_out.clear();
+            clk_t::time_point start = clk_t::now();
+            for(auto& it: av->awy_db->get_db())
+            {
+                if(av->awy_db->is_in_awy(it.first, uid))
+                {
+                    scan_out.push_back(it.first);
+                }
+            }
+            clk_t::time_point mid = clk_t::now();
+            libnav::span_t<uint32_t> awys = av->awy_db->get_fix_awys(uid);
+            clk_t::time_point end = clk_t::now();
+
+            scan_ms += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                mid - start).count()) / 1000;
+            index_ms += double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                end - mid).count()) / 1000000;
+
+            std::sort(scan_out.begin(), scan_out.end());
+            bool is_eq = scan_out.size() == awys.size();
+            for(size_t i = 0; is_eq && i < awys.size(); i++)
+            {
+                is_eq = scan_out[i] == av->awy_db->get_awy_name(awys[i]);
+            }
+            n_mismatch += size_t(!is_eq);
+            n_awys += awys.size();
+        }
+
+        std::cout << "Airways listed: " << n_awys << " mismatches: " << n_mismatch << "\n";
+        std::cout << "Full scan: " << scan_ms << " ms reverse index: " << index_ms << " ms\n";
+    }
+
+    inline bool awy_path_eq(Avionics* av, std::vector<libnav::awy_point_t>& p1, 
+        std::vector<libnav::awy_hop_t>& p2)
+    {
+        if(p1.size() != p2.size())
+        {
+            return false;
+        }
+        for(size_t i = 0; i < p1.size(); i++)
+        {
+            if(p1[i].id != av->awy_db->get_fix_uid(p2[i].fix) || 
+                p1[i].alt_restr.lower != p2[i].alt_restr.lower ||
+                p1[i].alt_restr.upper != p2[i].alt_restr.upper)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline void pathbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of queries>\n";
+            return;
+        }
+
+        int n_queries = strutils::stoi_with_strip(in[0]);
+        std::shared_ptr<libnav::AwyDB> db = av->awy_db;
+        if(db->get_n_awys() == 0)
+        {
+            return;
+        }
+
+        // Random airway with 2 random fixes on it and a random crossing airway
+        std::mt19937 gen(1);
+        std::vector<std::vector<std::string>> queries;
+        for(int i = 0; i < n_queries; i++)
+        {
+            std::string awy = db->get_awy_name(uint32_t(gen() % db->get_n_awys()));
+            const libnav::graph_t& graph = db->get_db().at(awy);
+            auto it_1 = std::next(graph.begin(), long(gen() % graph.size()));
+            auto it_2 = std::next(graph.begin(), long(gen() % graph.size()));
+            std::string next_awy = awy;
+            const libnav::awy_isect_t* isect = db->get_isect(awy);
+            if(isect != nullptr)
+            {
+                next_awy = std::next(isect->begin(), long(gen() % isect->size()))->first;
+            }
+            queries.push_back({awy, it_1->first, it_2->first, next_awy});
+        }
+
+        typedef std::chrono::steady_clock clk_t;
+        size_t n_mismatch = 0;
+        size_t n_ties = 0;
+        size_t n_found = 0;
+        double str_ms = 0;
+        double idx_ms = 0;
+        libnav::awy_scratch_t scratch;
+        std::vector<libnav::awy_point_t> p_str;
+        std::vector<libnav::awy_hop_t> p_idx;
+        for(auto& q: queries)
+        {
+            uint32_t awy = db->get_awy_idx(q[0]);
+            uint32_t start = db->get_fix_idx(q[1]);
+            uint32_t end = db->get_fix_idx(q[2]);
+            uint32_t next_awy = db->get_awy_idx(q[3]);
+            for(int j = 0; j < 2; j++)
+            {
+                p_str.clear();
+                p_idx.clear();
+                clk_t::time_point t1 = clk_t::now();
+                if(j == 0)
+                    db->get_ww_path(q[0], q[1], q[2], &p_str);
+                else
+                    db->get_aa_path(q[0], q[1], q[3], &p_str);
+                clk_t::time_point t2 = clk_t::now();
+                if(j == 0)
+                    db->get_ww_path(awy, start, end, &scratch, &p_idx);
+                else
+                    db->get_aa_path(awy, start, next_awy, &scratch, &p_idx);
+                clk_t::time_point t3 = clk_t::now();
+
+                str_ms += double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    t2 - t1).count()) / 1000000;
+                idx_ms += double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    t3 - t2).count()) / 1000000;
+                n_found += size_t(p_idx.size() != 0);
+                // Both searches are breadth first, but they may break ties between
+                // branches of an airway differently.
+                n_mismatch += size_t(p_str.size() != p_idx.size());
+                n_ties += size_t(p_str.size() == p_idx.size() && 
+                    !awy_path_eq(av, p_str, p_idx));
+            }
+        }
+
+        std::cout << "Paths found: " << n_found << "/" << 2 * queries.size() << 
+            " length mismatches: " << n_mismatch << " different paths of equal length: " <<
+            n_ties << "\n";
+        std::cout << "String maps: " << str_ms << " ms scratch: " << idx_ms << " ms\n";
+    }
+
+    inline void expand(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() == 0)
+        {
+            std::cout << "Command expects a route: <fix> <airway> <fix> ...\n";
+            return;
+        }
+
+        std::string route = in[0];
+        for(size_t i = 1; i < in.size(); i++)
+        {
+            route += " " + in[i];
+        }
+
+        libnav::RouteExpander exp(av->navaid_db_ptr, av->awy_db, av->arpt_db_ptr);
+        libnav::awy_scratch_t scratch;
+        libnav::route_result_t res;
+        exp.expand_route(route, &scratch, &res);
+
+        for(size_t i = 0; i < res.tokens.size(); i++)
+        {
+            std::cout << res.tokens[i] << ":" << int(res.token_errs[i]) << " ";
+        }
+        std::cout << "\nValid: " << res.is_valid << "\n";
+        for(auto& leg: res.legs)
+        {
+            geo::point pos = leg.data.pos;
+            std::cout << leg.id << " " << (leg.awy == "" ? "DCT" : leg.awy) << " " <<
+                strutils::lat_to_str(pos.lat_rad * geo::RAD_TO_DEG) << " " << 
+                strutils::lon_to_str(pos.lon_rad * geo::RAD_TO_DEG) << " " <<
+                leg.alt_restr.lower << " " << leg.alt_restr.upper << "\n";
+        }
+    }
+
+    inline void expandbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 2)
+        {
+            std::cout << "Command expects 2 arguments: <number of routes> <max distance nm>\n";
+            return;
+        }
+
+        int n_routes = strutils::stoi_with_strip(in[0]);
+        double max_dist_nm = double(strutils::stof_with_strip(in[1]));
+        std::shared_ptr<libnav::AwyRouter> router = av->get_awy_router();
+        if(router->get_n_nodes() == 0)
+        {
+            return;
+        }
+
+        // Route strings are made from the router's output, so that the expanded
+        // fixes can be checked against it.
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<size_t> dist(0, router->get_n_nodes() - 1);
+        std::vector<std::string> routes;
+        std::vector<std::vector<libnav::awy_route_leg_t>> ref;
+        while(int(routes.size()) < n_routes)
+        {
+            uint32_t s = uint32_t(dist(gen));
+            uint32_t e = uint32_t(dist(gen));
+            const libnav::waypoint_entry_t* w1 = av->awy_db->get_fix_wpt(s);
+            const libnav::waypoint_entry_t* w2 = av->awy_db->get_fix_wpt(e);
+            if(w1 == nullptr || w2 == nullptr)
+            {
+                continue;
+            }
+            geo::point p1 = w1->pos;
+            std::vector<libnav::awy_route_leg_t> route;
+            if(p1.get_gc_dist_nm(w2->pos) <= max_dist_nm && 
+                router->get_route(router->get_node_uid(s), router->get_node_uid(e), 
+                &route) > 1)
+            {
+                routes.push_back(awy_route_to_str(route));
+                ref.push_back(route);
+            }
+        }
+
+        typedef std::chrono::steady_clock clk_t;
+        libnav::RouteExpander exp_seq(av->navaid_db_ptr, av->awy_db, av->arpt_db_ptr);
+        libnav::awy_scratch_t scratch;
+        std::vector<libnav::route_result_t> res_seq(routes.size());
+        clk_t::time_point start = clk_t::now();
+        for(size_t i = 0; i < routes.size(); i++)
+        {
+            exp_seq.expand_route(routes[i], &scratch, &res_seq[i]);
+        }
+        clk_t::time_point mid = clk_t::now();
+        libnav::RouteExpander exp_par(av->navaid_db_ptr, av->awy_db, av->arpt_db_ptr);
+        std::vector<libnav::route_result_t> res_par = exp_par.expand(routes);
+        clk_t::time_point end = clk_t::now();
+
+        size_t n_valid = 0;
+        size_t n_legs = 0;
+        size_t n_mismatch = 0;
+        for(size_t i = 0; i < routes.size(); i++)
+        {
+            n_valid += size_t(res_par[i].is_valid);
+            n_legs += res_par[i].legs.size();
+            bool is_eq = res_par[i].legs.size() == ref[i].size() && 
+                res_seq[i].legs.size() == ref[i].size();
+            for(size_t j = 0; is_eq && j < ref[i].size(); j++)
+            {
+                libnav::waypoint_t wpt = {res_par[i].legs[j].id, res_par[i].legs[j].data};
+                is_eq = wpt.get_awy_id() == ref[i][j].point.id && 
+                    res_seq[i].legs[j].id == res_par[i].legs[j].id;
+            }
+            n_mismatch += size_t(!is_eq);
+        }
+
+        double seq_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            mid - start).count()) / 1000;
+        double par_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            end - mid).count()) / 1000;
+        std::cout << "Routes: " << routes.size() << " valid: " << n_valid << " legs: " << 
+            n_legs << " differ from the router: " << n_mismatch << "\n";
+        std::cout << "Sequential: " << seq_ms << " ms parallel(" << 
+            libnav::get_default_executor()->get_n_workers() << " workers): " << par_ms << 
+            " ms cached ids: " << exp_par.get_n_cached() << "\n";
+    }
+
+    inline void joinbench(Avionics* av, std::vector<std::string>& in)
+    {
+        if(in.size() != 1)
+        {
+            std::cout << "Command expects 1 argument: <number of passes>\n";
+            return;
+        }
+
+        int n_passes = strutils::stoi_with_strip(in[0]);
+        typedef std::chrono::steady_clock clk_t;
+
+        clk_t::time_point start = clk_t::now();
+        size_t n_awy_unres = av->awy_db->link_navaids(av->navaid_db_ptr);
+        size_t n_hold_unres = av->hold_db->link_navaids(av->navaid_db_ptr);
+        double link_ms = double(std::chrono::duration_cast<std::chrono::microseconds>(
+            clk_t::now() - start).count()) / 1000;
+        std::cout << "Unresolved airway fixes: " << n_awy_unres << " hold fixes: " << 
+            n_hold_unres << " linked in " << link_ms << " ms\n";
+
+        std::vector<std::string> hold_ids;
+        for(auto& it: av->hold_db->get_db())
+        {
+            hold_ids.push_back(it.first);
+        }
+
+        size_t n_mismatch = 0;
+        double sink = 0;
+        double str_ms = 0;
+        double link_q_ms = 0;
+        std::vector<libnav::waypoint_entry_t> wpts;
+        for(int p = 0; p < n_passes; p++)
+        {
+            clk_t::time_point t1 = clk_t::now();
+            for(uint32_t i = 0; i < uint32_t(av->awy_db->get_n_fixes()); i++)
+            {
+                std::string uid = av->awy_db->get_fix_uid(i);
+                wpts.clear();
+                if(av->navaid_db_ptr->get_wpt_by_awy_str(uid, &wpts))
+                {
+                    geo::point pos = wpts[0].pos;
+                    sink += pos.lat_rad;
+                }
+            }
+            for(auto& id: hold_ids)
+            {
+                wpts.clear();
+                if(av->navaid_db_ptr->get_wpt_by_hold_str(id, &wpts))
+                {
+                    geo::point pos = wpts[0].pos;
+                    sink += pos.lat_rad;
+                }
+            }
+            clk_t::time_point t2 = clk_t::now();
+            for(uint32_t i = 0; i < uint32_t(av->awy_db->get_n_fixes()); i++)
+            {
+                const libnav::waypoint_entry_t* wpt = av->awy_db->get_fix_wpt(i);
+                if(wpt != nullptr)
+                {
+                    geo::point pos = wpt->pos;
+                    sink -= pos.lat_rad;
+                }
+            }
+            for(auto& id: hold_ids)
+            {
+                const libnav::waypoint_entry_t* wpt = av->hold_db->get_hold_wpt(id);
+                if(wpt != nullptr)
+                {
+                    geo::point pos = wpt->pos;
+                    sink -= pos.lat_rad;
+                }
+            }
+            clk_t::time_point t3 = clk_t::now();
+
+            str_ms += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                t2 - t1).count()) / 1000;
+            link_q_ms += double(std::chrono::duration_cast<std::chrono::microseconds>(
+                t3 - t2).count()) / 1000;
+        }
+
+        // Links must point to the same entries that the string lookups return first
+        for(uint32_t i = 0; i < uint32_t(av->awy_db->get_n_fixes()); i++)
+        {
+            std::string uid = av->awy_db->get_fix_uid(i);
+            wpts.clear();
+            av->navaid_db_ptr->get_wpt_by_awy_str(uid, &wpts);
+            const libnav::waypoint_entry_t* wpt = av->awy_db->get_fix_wpt(i);
+            n_mismatch += size_t((wpts.size() != 0) != (wpt != nullptr) || 
+                (wpt != nullptr && wpts[0] != *wpt));
+        }
+        for(auto& id: hold_ids)
+        {
+            wpts.clear();
+            av->navaid_db_ptr->get_wpt_by_hold_str(id, &wpts);
+            const libnav::waypoint_entry_t* wpt = av->hold_db->get_hold_wpt(id);
+            n_mismatch += size_t((wpts.size() != 0) != (wpt != nullptr) || 
+                (wpt != nullptr && wpts[0] != *wpt));
+        }
+
+        std::cout << "Fixes: " << av->awy_db->get_n_fixes() << " holds: " << 
+            hold_ids.size() << " mismatches: " << n_mismatch << "\n";
+        std::cout << "String lookups: " << str_ms << " ms links: " << link_q_ms << 
+            " ms (" << sink << ")\n";
     }
 
     inline void get_aa_path(Avionics* av, std::vector<std::string>& in)
@@ -335,9 +2115,10 @@ namespace dbg
         std::cout << "Select desired " << name << "\n";
         for(size_t i = 0; i < wpts.size(); i++)
         {
-            std::cout << i+1 << ". " << strutils::lat_to_str(wpts[i].pos.lat_rad 
+            geo::point wpt_pos = wpts[i].pos;
+            std::cout << i+1 << ". " << strutils::lat_to_str(wpt_pos.lat_rad 
                 * geo::RAD_TO_DEG) 
-                << " " << strutils::lat_to_str(wpts[i].pos.lon_rad
+                << " " << strutils::lat_to_str(wpt_pos.lon_rad
                 * geo::RAD_TO_DEG) << "\n";
         }
         while(1)
@@ -389,6 +2170,7 @@ namespace dbg
                 std::cout << "Minimum altitude(feet): " << hld_data[i].min_alt_ft << "\n";
                 std::cout << "Maximum altitude(feet): " << hld_data[i].max_alt_ft << "\n";
                 std::cout << "Speed restriction(knots): " << hld_data[i].spd_kts << "\n";
+                
                 std::cout << "\n";
             }
             
@@ -659,6 +2441,33 @@ namespace dbg
         {"p", print},
         {"name", name}, 
         {"poinfo", display_poi_info}, 
+        {"nearby", nearby},
+        {"packchk", packchk},
+        {"radnav", radnav},
+        {"tune", tune},
+        {"aptinfo", aptinfo},
+        {"aptbench", aptbench},
+        {"phases", phases},
+        {"swapdb", swapdb},
+        {"cancelload", cancelload},
+        {"aptasync", aptasync},
+        {"aptcache", aptcache},
+        {"cifpbuild", cifpbuild},
+        {"cifpbench", cifpbench},
+        {"arincbench", arincbench},
+        {"numbench", numbench},
+        {"splitbench", splitbench},
+        {"fmtbench", fmtbench},
+        {"awyroute", awyroute},
+        {"routebench", routebench},
+        {"crossawy", crossawy},
+        {"aabench", aabench},
+        {"fixawys", fixawys},
+        {"fixawybench", fixawybench},
+        {"pathbench", pathbench},
+        {"expand", expand},
+        {"expandbench", expandbench},
+        {"joinbench", joinbench},
         {"get_path", get_path},
         {"get_aa_path", get_aa_path},
         {"holdinfo", hold_info},